@@ -101,7 +101,11 @@ context (ostream& os_,
       options (ops),
       modifier (options.generate_modifier ()),
       specifier (options.generate_specifier ()),
+      pack (options.pack_flags ()),
+      tabular (options.parse_backend () == "table"),
       usage (!options.suppress_usage ()),
+      cxx11 (options.std () != "c++98"),
+      cxx17 (options.std () == "c++17"),
       inl (data_->inl_),
       opt_prefix (options.option_prefix ()),
       opt_sep (options.option_separator ()),
@@ -129,7 +133,11 @@ context (context& c)
       options (c.options),
       modifier (c.modifier),
       specifier (c.specifier),
+      pack (c.pack),
+      tabular (c.tabular),
       usage (c.usage),
+      cxx11 (c.cxx11),
+      cxx17 (c.cxx17),
       inl (c.inl),
       opt_prefix (c.opt_prefix),
       opt_sep (c.opt_sep),
@@ -624,6 +632,37 @@ fq_name (semantics::nameable& n, bool cxx_name)
   return r;
 }
 
+bool context::
+packed (semantics::option& o) const
+{
+  return pack &&
+    (o.type ().name () == "bool" ? !o.lazy () : specifier);
+}
+
+bool context::
+validated (semantics::class_& c)
+{
+  if (presence_count (c) != 0)
+    return true;
+
+  for (semantics::class_::inherits_iterator i (c.inherits_begin ());
+       i != c.inherits_end ();
+       ++i)
+  {
+    if (validated (i->base ()))
+      return true;
+  }
+
+  return false;
+}
+
+string context::
+member_type (semantics::option& o) const
+{
+  string const& t (o.type ().name ());
+  return o.sink () ? cli + "::sink< " + t + " >" : t;
+}
+
 void context::
 cli_open ()
 {
@@ -40,7 +40,11 @@ public:
 
   bool modifier;
   bool specifier;
+  bool pack; // Bool options and specifiers are stored as bits.
+  bool tabular; // Option values are parsed by the table-driven backend.
   bool usage;
+  bool cxx11; // Generated code can use C++11 features.
+  bool cxx17; // Generated code can use C++17 features.
 
   string const& inl;
   string const& opt_prefix;
@@ -112,12 +116,98 @@ public:
     return n.context ().get<string> ("specifier-member");
   }
 
+  static string const&
+  elazy_member (semantics::nameable& n)
+  {
+    return n.context ().get<string> ("lazy-member");
+  }
+
+  static string const&
+  eflag (semantics::nameable& n)
+  {
+    return n.context ().get<string> ("flag");
+  }
+
+  static string const&
+  eflags (semantics::nameable& n)
+  {
+    return n.context ().get<string> ("flags");
+  }
+
+  static string const&
+  eflags_member (semantics::nameable& n)
+  {
+    return n.context ().get<string> ("flags-member");
+  }
+
 public:
   // Return fully-qualified C++ or CLI name.
   //
   string
   fq_name (semantics::nameable& n, bool cxx_name = true);
 
+  // With --pack-flags, the value of a bool option and the specifier
+  // flag of any other option are stored as a bit in the flags member
+  // of the class. Return true if the option has such a bit. Lazy bool
+  // options are not packed.
+  //
+  bool
+  packed (semantics::option&) const;
+
+  static size_t
+  flag_bit (semantics::nameable& n)
+  {
+    return n.context ().get<size_t> ("flag-bit");
+  }
+
+  // Return the number of flag bits in the class.
+  //
+  static size_t
+  flag_count (semantics::nameable& c)
+  {
+    return c.context ().get<size_t> ("flag-count");
+  }
+
+  // Options referenced in the class constraints have a bit in the
+  // presence mask of the class.
+  //
+  static bool
+  presence_p (semantics::nameable& n)
+  {
+    return n.context ().count ("presence-bit") != 0;
+  }
+
+  static size_t
+  presence_bit (semantics::nameable& n)
+  {
+    return n.context ().get<size_t> ("presence-bit");
+  }
+
+  static size_t
+  presence_count (semantics::nameable& c)
+  {
+    return c.context ().get<size_t> ("presence-count");
+  }
+
+  static string const&
+  epresence_member (semantics::nameable& c)
+  {
+    return c.context ().get<string> ("presence-member");
+  }
+
+  // Return true if the class or any of its bases have constraints, in
+  // which case the class has the _validate() function that checks the
+  // constraints of its bases and then its own.
+  //
+  static bool
+  validated (semantics::class_&);
+
+  // Return the C++ type of the option data member. For a sink option
+  // this is the sink type rather than the value type.
+  //
+  string
+  member_type (semantics::option&) const;
+
   // Open/close cli namespace.
   //
 public:
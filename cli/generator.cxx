@@ -143,6 +143,57 @@ generate (options const& ops, semantics::cli_unit& unit, path const& p)
       }
     }
 
+    if (ops.generate_file_cache () && !ops.generate_file_scanner ())
+    {
+      cerr << "error: --generate-file-cache can only be used with "
+           << "--generate-file-scanner" << endl;
+      throw failed ();
+    }
+
+    {
+      string const& l (ops.option_lookup ());
+
+      if (l != "map" && l != "hash" && l != "sorted")
+      {
+        cerr << "error: unknown option lookup type '" << l << "'" << endl;
+        throw failed ();
+      }
+    }
+
+    {
+      string const& b (ops.parse_backend ());
+
+      if (b != "thunk" && b != "table")
+      {
+        cerr << "error: unknown parse backend '" << b << "'" << endl;
+        throw failed ();
+      }
+    }
+
+    {
+      string const& v (ops.std ());
+
+      if (v != "c++98" && v != "c++11" && v != "c++17")
+      {
+        cerr << "error: unknown C++ standard '" << v << "'" << endl;
+        throw failed ();
+      }
+    }
+
+    if (ops.bundle_short_options () && ops.option_prefix () != "-")
+    {
+      cerr << "error: --bundle-short-options can only be used with the "
+           << "default option prefix" << endl;
+      throw failed ();
+    }
+
+    if (ops.generate_parse_batch () && ops.std () == "c++98")
+    {
+      cerr << "error: --generate-parse-batch requires --std c++11 or later"
+           << endl;
+      throw failed ();
+    }
+
     fs::auto_removes auto_rm;
 
     // C++ output.
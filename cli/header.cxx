@@ -17,17 +17,41 @@ namespace
     traverse (type& o)
     {
       string name (ename (o));
-      string type (o.type ().name ());
+      string type (member_type (o));
 
-      os << "const " << type << "&" << endl
-         << name << " () const;"
-         << endl;
+      // The value of a packed bool option is stored as a bit and is
+      // therefore returned by value.
+      //
+      bool bit (packed (o) && type == "bool");
+
+      if (bit)
+        os << "bool" << endl
+           << name << " () const;"
+           << endl;
+      else
+        os << "const " << type << "&" << endl
+           << name << " () const;"
+           << endl;
+
+      // Set the function that is called with each value of a sink
+      // option as it is parsed.
+      //
+      if (o.sink ())
+        os << "void" << endl
+           << name << " (void (*) (const " << o.type ().name () <<
+          "&, void*), void* arg = 0);"
+           << endl;
 
       if (modifier)
       {
-        os << type << "&" << endl
-           << name << " ();"
-           << endl;
+        if (bit)
+          os << cli << "::flag_ref" << endl
+             << name << " ();"
+             << endl;
+        else
+          os << type << "&" << endl
+             << name << " ();"
+             << endl;
 
         os << "void" << endl
            << name << " (const " << type << "&);"
@@ -60,15 +84,46 @@ namespace
     traverse (type& o)
     {
       string member (emember (o));
-      string type (o.type ().name ());
+      string type (member_type (o));
 
-      os << type << " " << member << ";";
+      // The default value of a lazy option is assigned by the const
+      // accessor.
+      //
+      if (o.lazy ())
+        os << "mutable " << type << " " << member << ";"
+           << "mutable bool " << elazy_member (o) << ";";
+      else if (!packed (o) || type != "bool")
+        os << type << " " << member << ";";
 
-      if (specifier && type != "bool")
+      if (specifier && type != "bool" && !packed (o))
         os << "bool " << especifier_member (o) << ";";
     }
   };
 
+  // Index constants of the flag bits.
+  //
+  struct option_flag: traversal::option, context
+  {
+    option_flag (context& c) : context (c), first_ (true) {}
+
+    virtual void
+    traverse (type& o)
+    {
+      if (!packed (o))
+        return;
+
+      if (first_)
+        first_ = false;
+      else
+        os << "," << endl;
+
+      os << eflag (o) << " = " << flag_bit (o);
+    }
+
+  private:
+    bool first_;
+  };
+
   //
   //
   struct base: traversal::class_, context
@@ -129,37 +184,43 @@ namespace
       //
       if (!abst)
       {
-        os << name << " (int& argc," << endl
-           << "char** argv," << endl
-           << "bool erase = false," << endl
-           << um << " option = " << um << "::fail," << endl
-           << um << " argument = " << um << "::stop);"
-           << endl;
+        // Without exceptions there is no way to report an error from
+        // the argc/argv c-tors so only the scanner one is provided.
+        //
+        if (!options.suppress_exceptions ())
+        {
+          os << name << " (int& argc," << endl
+             << "char** argv," << endl
+             << "bool erase = false," << endl
+             << um << " option = " << um << "::fail," << endl
+             << um << " argument = " << um << "::stop);"
+             << endl;
 
-        os << name << " (int start," << endl
-           << "int& argc," << endl
-           << "char** argv," << endl
-           << "bool erase = false," << endl
-           << um << " option = " << um << "::fail," << endl
-           << um << " argument = " << um << "::stop);"
-           << endl;
+          os << name << " (int start," << endl
+             << "int& argc," << endl
+             << "char** argv," << endl
+             << "bool erase = false," << endl
+             << um << " option = " << um << "::fail," << endl
+             << um << " argument = " << um << "::stop);"
+             << endl;
 
-        os << name << " (int& argc," << endl
-           << "char** argv," << endl
-           << "int& end," << endl
-           << "bool erase = false," << endl
-           << um << " option = " << um << "::fail," << endl
-           << um << " argument = " << um << "::stop);"
-           << endl;
+          os << name << " (int& argc," << endl
+             << "char** argv," << endl
+             << "int& end," << endl
+             << "bool erase = false," << endl
+             << um << " option = " << um << "::fail," << endl
+             << um << " argument = " << um << "::stop);"
+             << endl;
 
-        os << name << " (int start," << endl
-           << "int& argc," << endl
-           << "char** argv," << endl
-           << "int& end," << endl
-           << "bool erase = false," << endl
-           << um << " option = " << um << "::fail," << endl
-           << um << " argument = " << um << "::stop);"
-           << endl;
+          os << name << " (int start," << endl
+             << "int& argc," << endl
+             << "char** argv," << endl
+             << "int& end," << endl
+             << "bool erase = false," << endl
+             << um << " option = " << um << "::fail," << endl
+             << um << " argument = " << um << "::stop);"
+             << endl;
+        }
 
         os << name << " (" << cli << "::scanner&," << endl
            << um << " option = " << um << "::fail," << endl
@@ -170,6 +231,28 @@ namespace
            << endl;
       }
 
+      // reset () and parse ()
+      //
+      if (options.generate_parse ())
+      {
+        os << "// Restore the default option values, including those of" << endl
+           << "// the bases." << endl
+           << "//" << endl
+           << "void" << endl
+           << "reset ();"
+           << endl;
+
+        if (!abst)
+          os << "// Parse the options from the scanner into this object." << endl
+             << "// Call reset() first to parse a new command line." << endl
+             << "//" << endl
+             << "void" << endl
+             << "parse (" << cli << "::scanner&," << endl
+             << um << " option = " << um << "::fail," << endl
+             << um << " argument = " << um << "::stop);"
+             << endl;
+      }
+
       //
       //
       os << "// Option accessors" << (modifier ? " and modifiers." : ".") << endl
@@ -177,6 +260,31 @@ namespace
 
       names (c, names_option_);
 
+      // Flags.
+      //
+      size_t bits (flag_count (c));
+
+      if (bits != 0)
+      {
+        os << "// Bool option values and option specified flags. The" << endl
+           << "// bit of each option is given by the enumerator below." << endl
+           << "//" << endl
+           << "enum"
+           << "{";
+
+        {
+          option_flag f (*this);
+          traversal::names n (f);
+          names (c, n);
+        }
+
+        os << "};";
+
+        os << "const " << cli << "::flag_set< " << bits << " >&" << endl
+           << eflags (c) << " () const;"
+           << endl;
+      }
+
       // Usage.
       //
       if (usage)
@@ -224,6 +332,13 @@ namespace
          << "_parse (const char*, " << cli << "::scanner&);"
          << endl;
 
+      // _validate ()
+      //
+      if (validated (c))
+        os << "void" << endl
+           << "_validate (" << cli << "::scanner&) const;"
+           << endl;
+
       // _parse ()
       //
       if (!abst)
@@ -234,12 +349,25 @@ namespace
            << um << " argument);"
            << endl;
 
+      if (!abst && options.bundle_short_options ())
+        os << "bool" << endl
+           << "_parse_bundle (" << cli << "::scanner&);"
+           << endl;
+
       // Data members.
       //
       os << "public:" << endl; //@@ tmp
 
       names (c, names_option_data_);
 
+      if (bits != 0)
+        os << cli << "::flag_set< " << bits << " > " << eflags_member (c) <<
+          ";";
+
+      if (presence_count (c) != 0)
+        os << cli << "::flag_set< " << presence_count (c) << " > " <<
+          epresence_member (c) << ";";
+
       os << "};";
     }
 
@@ -3,6 +3,8 @@
 // copyright : Copyright (c) 2009-2011 Code Synthesis Tools CC
 // license   : MIT; see accompanying LICENSE file
 
+#include <sstream>
+
 #include "inline.hxx"
 
 namespace
@@ -13,49 +15,155 @@ namespace
   {
     option (context& c) : context (c) {}
 
+    // Assign the default value of a lazy option on the first read.
+    //
+    void
+    lazy_init (type& o)
+    {
+      if (!o.lazy ())
+        return;
+
+      using semantics::expression;
+      expression const& i (o.initializer ());
+      string member ("this->" + emember (o));
+      string lazy ("this->" + elazy_member (o));
+
+      os << "if (" << lazy << ")"
+         << "{";
+
+      // See option_reset in source.cxx for why the typedef is needed.
+      //
+      if (i.type () == expression::call_expr)
+        os << "typedef " << o.type ().name () << " _cli_type;";
+
+      os << member << " = ";
+
+      switch (i.type ())
+      {
+      case expression::string_lit:
+      case expression::char_lit:
+      case expression::bool_lit:
+      case expression::int_lit:
+      case expression::float_lit:
+      case expression::identifier:
+        {
+          os << i.value ();
+          break;
+        }
+      case expression::call_expr:
+        {
+          os << "_cli_type " << i.value ();
+          break;
+        }
+      }
+
+      os << ";"
+         << lazy << " = false;"
+         << "}";
+    }
+
     virtual void
     traverse (type& o)
     {
       string name (ename (o));
-      string type (o.type ().name ());
+      string type (member_type (o));
       string scope (escape (o.scope ().name ()));
 
-      os << inl << "const " << type << "& " << scope << "::" << endl
-         << name << " () const"
-         << "{"
-         << "return this->" << emember (o) << ";"
-         << "}";
+      // Packed bool option value or specifier flag.
+      //
+      bool p (packed (o));
+      string bit;
 
-      if (modifier)
+      if (p)
       {
-        os << inl << type << "& " << scope << "::" << endl
-           << name << " ()"
+        std::ostringstream ostr;
+        ostr << "this->" << eflags_member (o.scope ()) << "[" <<
+          flag_bit (o) << "]";
+        bit = ostr.str ();
+      }
+
+      if (p && type == "bool")
+        os << inl << "bool " << scope << "::" << endl
+           << name << " () const"
            << "{"
-           << "return this->" << emember (o) << ";"
+           << "return " << bit << ";"
            << "}";
+      else
+      {
+        os << inl << "const " << type << "& " << scope << "::" << endl
+           << name << " () const"
+           << "{";
+
+        lazy_init (o);
 
+        os << "return this->" << emember (o) << ";"
+           << "}";
+      }
+
+      if (o.sink ())
         os << inl << "void " << scope << "::" << endl
-           << name << "(const " << type << "& x)"
+           << name << " (void (*f) (const " << o.type ().name () <<
+          "&, void*), void* arg)"
            << "{"
-           << "this->" << emember (o) << " = x;"
+           << "this->" << emember (o) << ".func = f;"
+           << "this->" << emember (o) << ".arg = arg;"
            << "}";
+
+      if (modifier)
+      {
+        if (p && type == "bool")
+        {
+          os << inl << cli << "::flag_ref " << scope << "::" << endl
+             << name << " ()"
+             << "{"
+             << "return " << bit << ";"
+             << "}";
+
+          os << inl << "void " << scope << "::" << endl
+             << name << "(const " << type << "& x)"
+             << "{"
+             << bit << " = x;"
+             << "}";
+        }
+        else
+        {
+          os << inl << type << "& " << scope << "::" << endl
+             << name << " ()"
+             << "{";
+
+          lazy_init (o);
+
+          os << "return this->" << emember (o) << ";"
+             << "}";
+
+          os << inl << "void " << scope << "::" << endl
+             << name << "(const " << type << "& x)"
+             << "{"
+             << "this->" << emember (o) << " = x;";
+
+          if (o.lazy ())
+            os << "this->" << elazy_member (o) << " = false;";
+
+          os << "}";
+        }
       }
 
       if (specifier && type != "bool")
       {
         string spec (especifier (o));
+        string m (p ? bit : "this->" + especifier_member (o));
 
         os << inl << "bool " << scope << "::" << endl
            << spec << " () const"
            << "{"
-           << "return this->" << especifier_member (o) << ";"
+           << "return " << m << ";"
            << "}";
 
         if (modifier)
           os << inl << "void " << scope << "::" << endl
              << spec << "(bool x)"
              << "{"
-             << "this->" << especifier_member (o) << " = x;"
+             << m << " = x;"
              << "}";
       }
     }
@@ -81,6 +189,14 @@ namespace
          << endl;
 
       names (c, names_option_);
+
+      if (flag_count (c) != 0)
+        os << inl << "const " << cli << "::flag_set< " << flag_count (c) <<
+          " >& " << name << "::" << endl
+           << eflags (c) << " () const"
+           << "{"
+           << "return this->" << eflags_member (c) << ";"
+           << "}";
     }
 
   private:
@@ -103,9 +103,22 @@ unget (xchar c)
   unget_ = true;
 }
 
+void lexer::
+unget (token const& t)
+{
+  tbuf_.push_back (t);
+}
+
 token lexer::
 next ()
 {
+  if (!tbuf_.empty ())
+  {
+    token t (tbuf_.back ());
+    tbuf_.pop_back ();
+    return t;
+  }
+
   while (true) // Recovery loop.
   {
     bool include (include_);
@@ -8,6 +8,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include <locale>
 #include <cstddef> // std::size_t
 #include <istream>
@@ -22,6 +23,12 @@ public:
   token
   next ();
 
+  // Return the token from the next call to next(). Several tokens can
+  // be returned this way in the reverse order of the unget() calls.
+  //
+  void
+  unget (token const&);
+
   bool
   valid () const;
 
@@ -136,6 +143,8 @@ private:
 
   xchar buf_;
   bool unget_;
+
+  std::vector<token> tbuf_;
 };
 
 #include "lexer.ixx"
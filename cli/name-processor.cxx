@@ -77,24 +77,37 @@ namespace
 
   struct intermediate_option: traversal::option, context
   {
-    intermediate_option (context& c, name_set& set)
-        : context (c), set_ (set)
+    intermediate_option (context& c, name_set& set, size_t& bits)
+        : context (c), set_ (set), bits_ (bits)
     {
     }
 
     virtual void
     traverse (type& o)
     {
+      semantics::context& oc (o.context ());
+
       if (specifier && o.type ().name () != "bool")
       {
-        semantics::context& oc (o.context ());
         string const& base (oc.get<string> ("name"));
         oc.set ("specifier", find_name (base + "_specified", set_));
       }
+
+      // Assign the flag bit and the name of its index constant.
+      //
+      if (packed (o))
+      {
+        string const& base (
+          oc.get<string> (o.type ().name () == "bool" ? "name" : "specifier"));
+
+        oc.set ("flag", find_name (base + "_bit", set_));
+        oc.set ("flag-bit", bits_++);
+      }
     }
 
   private:
     name_set& set_;
+    size_t& bits_;
   };
 
   struct secondary_option: traversal::option, context
@@ -116,12 +129,30 @@ namespace
         string const& base (oc.get<string> ("specifier"));
         oc.set ("specifier-member", find_name (base + "_", set_));
       }
+
+      if (o.lazy ())
+      {
+        string const& base (oc.get<string> ("name"));
+        oc.set ("lazy-member", find_name (base + "_lazy_", set_));
+      }
     }
 
   private:
     name_set& set_;
   };
 
+  // Assign the next presence bit to the option unless it already has
+  // one.
+  //
+  void
+  assign_presence_bit (semantics::option& o, size_t& n)
+  {
+    semantics::context& oc (o.context ());
+
+    if (oc.count ("presence-bit") == 0)
+      oc.set ("presence-bit", n++);
+  }
+
   struct class_: traversal::class_, context
   {
     class_ (context& c) : context (c) {}
@@ -147,13 +178,41 @@ namespace
 
       // Then assign intermediate names.
       //
+      size_t bits (0);
       {
-        intermediate_option option (*this, member_set);
+        intermediate_option option (*this, member_set, bits);
         traversal::names names (option);
 
         class_::names (c, names);
       }
 
+      cc.set ("flag-count", bits);
+
+      if (bits != 0)
+        cc.set ("flags", find_name ("flags", member_set));
+
+      // Options referenced in the constraints get a bit in the presence
+      // mask that is maintained by _parse().
+      //
+      size_t presence (0);
+      {
+        typedef semantics::class_::constraint_list constraints;
+        constraints const& cs (c.constraints ());
+
+        for (constraints::const_iterator i (cs.begin ());
+             i != cs.end (); ++i)
+        {
+          if (i->dependent != 0)
+            assign_presence_bit (*i->dependent, presence);
+
+          for (std::vector<semantics::option*>::const_iterator j (
+                 i->options.begin ()); j != i->options.end (); ++j)
+            assign_presence_bit (**j, presence);
+        }
+      }
+
+      cc.set ("presence-count", presence);
+
       // Finally assign secondary names.
       //
       {
@@ -162,6 +221,13 @@ namespace
 
         class_::names (c, names);
       }
+
+      if (bits != 0)
+        cc.set ("flags-member",
+                find_name (cc.get<string> ("flags") + "_", member_set));
+
+      if (presence != 0)
+        cc.set ("presence-member", find_name ("presence_", member_set));
     }
   };
 
@@ -553,11 +553,25 @@ options ()
   version_ (),
   include_path_ (),
   output_dir_ (),
+  std_ ("c++98"),
   generate_modifier_ (),
   generate_specifier_ (),
+  pack_flags_ (),
   generate_description_ (),
+  generate_parse_ (),
+  generate_parse_batch_ (),
   generate_file_scanner_ (),
+  generate_file_cache_ (),
+  generate_string_scanner_ (),
+  generate_buffer_scanners_ (),
+  generate_stream_scanner_ (),
+  generate_numeric_parsers_ (),
+  generate_string_ref_ (),
+  option_lookup_ ("map"),
+  parse_backend_ ("thunk"),
+  bundle_short_options_ (),
   suppress_inline_ (),
+  suppress_exceptions_ (),
   ostream_type_ ("::std::ostream"),
   suppress_undocumented_ (),
   suppress_usage_ (),
@@ -615,11 +629,25 @@ options (int& argc,
   version_ (),
   include_path_ (),
   output_dir_ (),
+  std_ ("c++98"),
   generate_modifier_ (),
   generate_specifier_ (),
+  pack_flags_ (),
   generate_description_ (),
+  generate_parse_ (),
+  generate_parse_batch_ (),
   generate_file_scanner_ (),
+  generate_file_cache_ (),
+  generate_string_scanner_ (),
+  generate_buffer_scanners_ (),
+  generate_stream_scanner_ (),
+  generate_numeric_parsers_ (),
+  generate_string_ref_ (),
+  option_lookup_ ("map"),
+  parse_backend_ ("thunk"),
+  bundle_short_options_ (),
   suppress_inline_ (),
+  suppress_exceptions_ (),
   ostream_type_ ("::std::ostream"),
   suppress_undocumented_ (),
   suppress_usage_ (),
@@ -680,11 +708,25 @@ options (int start,
   version_ (),
   include_path_ (),
   output_dir_ (),
+  std_ ("c++98"),
   generate_modifier_ (),
   generate_specifier_ (),
+  pack_flags_ (),
   generate_description_ (),
+  generate_parse_ (),
+  generate_parse_batch_ (),
   generate_file_scanner_ (),
+  generate_file_cache_ (),
+  generate_string_scanner_ (),
+  generate_buffer_scanners_ (),
+  generate_stream_scanner_ (),
+  generate_numeric_parsers_ (),
+  generate_string_ref_ (),
+  option_lookup_ ("map"),
+  parse_backend_ ("thunk"),
+  bundle_short_options_ (),
   suppress_inline_ (),
+  suppress_exceptions_ (),
   ostream_type_ ("::std::ostream"),
   suppress_undocumented_ (),
   suppress_usage_ (),
@@ -745,11 +787,25 @@ options (int& argc,
   version_ (),
   include_path_ (),
   output_dir_ (),
+  std_ ("c++98"),
   generate_modifier_ (),
   generate_specifier_ (),
+  pack_flags_ (),
   generate_description_ (),
+  generate_parse_ (),
+  generate_parse_batch_ (),
   generate_file_scanner_ (),
+  generate_file_cache_ (),
+  generate_string_scanner_ (),
+  generate_buffer_scanners_ (),
+  generate_stream_scanner_ (),
+  generate_numeric_parsers_ (),
+  generate_string_ref_ (),
+  option_lookup_ ("map"),
+  parse_backend_ ("thunk"),
+  bundle_short_options_ (),
   suppress_inline_ (),
+  suppress_exceptions_ (),
   ostream_type_ ("::std::ostream"),
   suppress_undocumented_ (),
   suppress_usage_ (),
@@ -812,11 +868,25 @@ options (int start,
   version_ (),
   include_path_ (),
   output_dir_ (),
+  std_ ("c++98"),
   generate_modifier_ (),
   generate_specifier_ (),
+  pack_flags_ (),
   generate_description_ (),
+  generate_parse_ (),
+  generate_parse_batch_ (),
   generate_file_scanner_ (),
+  generate_file_cache_ (),
+  generate_string_scanner_ (),
+  generate_buffer_scanners_ (),
+  generate_stream_scanner_ (),
+  generate_numeric_parsers_ (),
+  generate_string_ref_ (),
+  option_lookup_ ("map"),
+  parse_backend_ ("thunk"),
+  bundle_short_options_ (),
   suppress_inline_ (),
+  suppress_exceptions_ (),
   ostream_type_ ("::std::ostream"),
   suppress_undocumented_ (),
   suppress_usage_ (),
@@ -875,11 +945,25 @@ options (::cli::scanner& s,
   version_ (),
   include_path_ (),
   output_dir_ (),
+  std_ ("c++98"),
   generate_modifier_ (),
   generate_specifier_ (),
+  pack_flags_ (),
   generate_description_ (),
+  generate_parse_ (),
+  generate_parse_batch_ (),
   generate_file_scanner_ (),
+  generate_file_cache_ (),
+  generate_string_scanner_ (),
+  generate_buffer_scanners_ (),
+  generate_stream_scanner_ (),
+  generate_numeric_parsers_ (),
+  generate_string_ref_ (),
+  option_lookup_ ("map"),
+  parse_backend_ ("thunk"),
+  bundle_short_options_ (),
   suppress_inline_ (),
+  suppress_exceptions_ (),
   ostream_type_ ("::std::ostream"),
   suppress_undocumented_ (),
   suppress_usage_ (),
@@ -941,19 +1025,67 @@ print_usage (::std::ostream& os)
   os << "--output-dir|-o <dir>        Write the generated files to <dir> instead of the" << ::std::endl
      << "                             current directory." << ::std::endl;
 
+  os << "--std <version>              Specify the C++ standard that should be used by" << ::std::endl
+     << "                             the generated code." << ::std::endl;
+
   os << "--generate-modifier          Generate option value modifiers in addition to" << ::std::endl
      << "                             accessors." << ::std::endl;
 
   os << "--generate-specifier         Generate functions for determining whether the" << ::std::endl
      << "                             option was specified on the command line." << ::std::endl;
 
+  os << "--pack-flags                 Store the values of the 'bool' options as well as" << ::std::endl
+     << "                             the option specified flags (see" << ::std::endl
+     << "                             '--generate-specifier') as bits in a single data" << ::std::endl
+     << "                             member instead of as separate 'bool' members." << ::std::endl;
+
   os << "--generate-description       Generate the option description list that can be" << ::std::endl
      << "                             examined at runtime." << ::std::endl;
 
+  os << "--generate-parse             Generate the 'reset()' and 'parse()' functions" << ::std::endl
+     << "                             that allow reusing an options object to parse" << ::std::endl
+     << "                             several command lines." << ::std::endl;
+
+  os << "--generate-parse-batch       Generate the 'parse_batch()' function template" << ::std::endl
+     << "                             that parses a range of command lines in parallel" << ::std::endl
+     << "                             using a pool of threads." << ::std::endl;
+
   os << "--generate-file-scanner      Generate the 'argv_file_scanner' implementation." << ::std::endl;
 
+  os << "--generate-file-cache        Generate the options file caching support in" << ::std::endl
+     << "                             'argv_file_scanner'." << ::std::endl;
+
+  os << "--generate-string-scanner    Generate the 'string_scanner' implementation." << ::std::endl;
+
+  os << "--generate-buffer-scanners   Generate the 'nul_scanner' and" << ::std::endl
+     << "                             'length_prefix_scanner' implementations." << ::std::endl;
+
+  os << "--generate-stream-scanner    Generate the 'stream_scanner' implementation." << ::std::endl;
+
+  os << "--generate-numeric-parsers   Generate 'parser' specializations for the" << ::std::endl
+     << "                             fundamental types (such as 'int', 'unsigned long'," << ::std::endl
+     << "                             'double', and 'char') that convert option values" << ::std::endl
+     << "                             without using 'std::istringstream'." << ::std::endl;
+
+  os << "--generate-string-ref        Generate the 'string_ref' type that can be used as" << ::std::endl
+     << "                             an option type instead of 'std::string'." << ::std::endl;
+
+  os << "--option-lookup <type>       Use <type> lookup to match command line arguments" << ::std::endl
+     << "                             against option names in the generated parsing" << ::std::endl
+     << "                             code." << ::std::endl;
+
+  os << "--parse-backend <backend>    Use <backend> to parse option values in the" << ::std::endl
+     << "                             generated parsing code." << ::std::endl;
+
+  os << "--bundle-short-options       Support POSIX-style bundling of single-character" << ::std::endl
+     << "                             options in the generated parsing code." << ::std::endl;
+
   os << "--suppress-inline            Generate all functions non-inline." << ::std::endl;
 
+  os << "--suppress-exceptions        Generate parsing code that reports errors by" << ::std::endl
+     << "                             recording them in the scanner instead of throwing" << ::std::endl
+     << "                             exceptions." << ::std::endl;
+
   os << "--ostream-type <type>        Output stream type instead of the default" << ::std::endl
      << "                             'std::ostream' that should be used to print usage" << ::std::endl
      << "                             and exception information." << ::std::endl;
@@ -1108,16 +1240,44 @@ struct _cli_options_map_init
     &::cli::thunk< options, std::string, &options::output_dir_ >;
     _cli_options_map_["-o"] = 
     &::cli::thunk< options, std::string, &options::output_dir_ >;
+    _cli_options_map_["--std"] = 
+    &::cli::thunk< options, std::string, &options::std_ >;
     _cli_options_map_["--generate-modifier"] = 
     &::cli::thunk< options, bool, &options::generate_modifier_ >;
     _cli_options_map_["--generate-specifier"] = 
     &::cli::thunk< options, bool, &options::generate_specifier_ >;
+    _cli_options_map_["--pack-flags"] = 
+    &::cli::thunk< options, bool, &options::pack_flags_ >;
     _cli_options_map_["--generate-description"] = 
     &::cli::thunk< options, bool, &options::generate_description_ >;
+    _cli_options_map_["--generate-parse"] = 
+    &::cli::thunk< options, bool, &options::generate_parse_ >;
+    _cli_options_map_["--generate-parse-batch"] = 
+    &::cli::thunk< options, bool, &options::generate_parse_batch_ >;
     _cli_options_map_["--generate-file-scanner"] = 
     &::cli::thunk< options, bool, &options::generate_file_scanner_ >;
+    _cli_options_map_["--generate-file-cache"] = 
+    &::cli::thunk< options, bool, &options::generate_file_cache_ >;
+    _cli_options_map_["--generate-string-scanner"] = 
+    &::cli::thunk< options, bool, &options::generate_string_scanner_ >;
+    _cli_options_map_["--generate-buffer-scanners"] = 
+    &::cli::thunk< options, bool, &options::generate_buffer_scanners_ >;
+    _cli_options_map_["--generate-stream-scanner"] = 
+    &::cli::thunk< options, bool, &options::generate_stream_scanner_ >;
+    _cli_options_map_["--generate-numeric-parsers"] = 
+    &::cli::thunk< options, bool, &options::generate_numeric_parsers_ >;
+    _cli_options_map_["--generate-string-ref"] = 
+    &::cli::thunk< options, bool, &options::generate_string_ref_ >;
+    _cli_options_map_["--option-lookup"] = 
+    &::cli::thunk< options, std::string, &options::option_lookup_ >;
+    _cli_options_map_["--parse-backend"] = 
+    &::cli::thunk< options, std::string, &options::parse_backend_ >;
+    _cli_options_map_["--bundle-short-options"] = 
+    &::cli::thunk< options, bool, &options::bundle_short_options_ >;
     _cli_options_map_["--suppress-inline"] = 
     &::cli::thunk< options, bool, &options::suppress_inline_ >;
+    _cli_options_map_["--suppress-exceptions"] = 
+    &::cli::thunk< options, bool, &options::suppress_exceptions_ >;
     _cli_options_map_["--ostream-type"] = 
     &::cli::thunk< options, std::string, &options::ostream_type_ >;
     _cli_options_map_["--suppress-undocumented"] = 
@@ -365,21 +365,63 @@ class options
   const std::string&
   output_dir () const;
 
+  const std::string&
+  std () const;
+
   const bool&
   generate_modifier () const;
 
   const bool&
   generate_specifier () const;
 
+  const bool&
+  pack_flags () const;
+
   const bool&
   generate_description () const;
 
+  const bool&
+  generate_parse () const;
+
+  const bool&
+  generate_parse_batch () const;
+
   const bool&
   generate_file_scanner () const;
 
+  const bool&
+  generate_file_cache () const;
+
+  const bool&
+  generate_string_scanner () const;
+
+  const bool&
+  generate_buffer_scanners () const;
+
+  const bool&
+  generate_stream_scanner () const;
+
+  const bool&
+  generate_numeric_parsers () const;
+
+  const bool&
+  generate_string_ref () const;
+
+  const std::string&
+  option_lookup () const;
+
+  const std::string&
+  parse_backend () const;
+
+  const bool&
+  bundle_short_options () const;
+
   const bool&
   suppress_inline () const;
 
+  const bool&
+  suppress_exceptions () const;
+
   const std::string&
   ostream_type () const;
 
@@ -536,11 +578,25 @@ class options
   bool version_;
   std::vector<std::string> include_path_;
   std::string output_dir_;
+  std::string std_;
   bool generate_modifier_;
   bool generate_specifier_;
+  bool pack_flags_;
   bool generate_description_;
+  bool generate_parse_;
+  bool generate_parse_batch_;
   bool generate_file_scanner_;
+  bool generate_file_cache_;
+  bool generate_string_scanner_;
+  bool generate_buffer_scanners_;
+  bool generate_stream_scanner_;
+  bool generate_numeric_parsers_;
+  bool generate_string_ref_;
+  std::string option_lookup_;
+  std::string parse_backend_;
+  bool bundle_short_options_;
   bool suppress_inline_;
+  bool suppress_exceptions_;
   std::string ostream_type_;
   bool suppress_undocumented_;
   bool suppress_usage_;
@@ -220,6 +220,12 @@ output_dir () const
   return this->output_dir_;
 }
 
+inline const std::string& options::
+std () const
+{
+  return this->std_;
+}
+
 inline const bool& options::
 generate_modifier () const
 {
@@ -232,24 +238,102 @@ generate_specifier () const
   return this->generate_specifier_;
 }
 
+inline const bool& options::
+pack_flags () const
+{
+  return this->pack_flags_;
+}
+
 inline const bool& options::
 generate_description () const
 {
   return this->generate_description_;
 }
 
+inline const bool& options::
+generate_parse () const
+{
+  return this->generate_parse_;
+}
+
+inline const bool& options::
+generate_parse_batch () const
+{
+  return this->generate_parse_batch_;
+}
+
 inline const bool& options::
 generate_file_scanner () const
 {
   return this->generate_file_scanner_;
 }
 
+inline const bool& options::
+generate_file_cache () const
+{
+  return this->generate_file_cache_;
+}
+
+inline const bool& options::
+generate_string_scanner () const
+{
+  return this->generate_string_scanner_;
+}
+
+inline const bool& options::
+generate_buffer_scanners () const
+{
+  return this->generate_buffer_scanners_;
+}
+
+inline const bool& options::
+generate_stream_scanner () const
+{
+  return this->generate_stream_scanner_;
+}
+
+inline const bool& options::
+generate_numeric_parsers () const
+{
+  return this->generate_numeric_parsers_;
+}
+
+inline const bool& options::
+generate_string_ref () const
+{
+  return this->generate_string_ref_;
+}
+
+inline const std::string& options::
+option_lookup () const
+{
+  return this->option_lookup_;
+}
+
+inline const std::string& options::
+parse_backend () const
+{
+  return this->parse_backend_;
+}
+
+inline const bool& options::
+bundle_short_options () const
+{
+  return this->bundle_short_options_;
+}
+
 inline const bool& options::
 suppress_inline () const
 {
   return this->suppress_inline_;
 }
 
+inline const bool& options::
+suppress_exceptions () const
+{
+  return this->suppress_exceptions_;
+}
+
 inline const std::string& options::
 ostream_type () const
 {
@@ -538,7 +538,7 @@ class_def ()
   {
     try
     {
-      if (!option_def (t))
+      if (!constraint_def (t) && !option_def (t))
         break;
 
       t = lexer_->next ();
@@ -572,15 +572,90 @@ option_def (token& t)
 {
   size_t l (t.line ()), c (t.column ());
 
+  // option-kind-seq
+  //
+  bool required (false), sink (false), lazy (false);
+
+  if (keyword (t, "required", true))
+  {
+    required = true;
+    t = lexer_->next ();
+
+    // required-group-def
+    //
+    bool ex (keyword (t, "exclusive", true));
+
+    if (ex || t.type () == token::t_string_lit)
+    {
+      constraint x;
+      x.required = true;
+
+      if (ex)
+      {
+        x.exclusive = true;
+        t = lexer_->next ();
+      }
+
+      option_group (t, x);
+
+      if (valid_)
+        dynamic_cast<class_&> (*scope_).constraints ().push_back (x);
+
+      return true;
+    }
+  }
+
+  if (keyword (t, "sink"))
+  {
+    sink = true;
+    t = lexer_->next ();
+  }
+  else if (keyword (t, "lazy"))
+  {
+    lazy = true;
+    t = lexer_->next ();
+  }
+
   // type-spec
   //
   // These two functions set t to the next token if they return
   // true.
   //
   string type_name;
+  size_t tl (t.line ()), tc (t.column ());
 
   if (!qualified_name (t, type_name) && !fundamental_type (t, type_name))
-    return false;
+  {
+    if (!required && !sink && !lazy)
+      return false;
+
+    cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+         << "expected option type instead of " << t << endl;
+    throw error ();
+  }
+
+  // If required is followed by an option name rather than a type, then
+  // this is a required-group-def.
+  //
+  if (required && !sink && !lazy &&
+      (t.punctuation () == token::p_or || t.punctuation () == token::p_semi))
+  {
+    constraint x;
+    x.required = true;
+    option_group (t, x, &type_name, tl, tc);
+
+    if (valid_)
+      dynamic_cast<class_&> (*scope_).constraints ().push_back (x);
+
+    return true;
+  }
+
+  if (sink && type_name == "bool")
+  {
+    cerr << *path_ << ':' << l << ':' << c << ": error: "
+         << "sink option cannot be of type bool" << endl;
+    throw error ();
+  }
 
   option* o (0);
 
@@ -589,6 +664,8 @@ option_def (token& t)
     o = &root_->new_node<option> (*path_, l, c);
     type& t (root_->new_type (*path_, l, c, type_name));
     root_->new_edge<belongs> (*o, t);
+    o->sink (sink);
+    o->lazy (lazy);
   }
 
   // option-name-seq
@@ -596,55 +673,17 @@ option_def (token& t)
   names::name_list nl;
   for (;;)
   {
-    switch (t.type ())
-    {
-    case token::t_identifier:
-      {
-        if (valid_)
-          nl.push_back (t.identifier ());
+    string n;
 
-        break;
-      }
-    case token::t_string_lit:
-      {
-        if (valid_)
-        {
-          // Get rid of '"'.
-          //
-          string r;
-          string const& l (t.literal ());
-          char p ('\0');
-
-          for (size_t i (0), n (l.size ()); i < n; ++i)
-          {
-            if (l[i] == '"' && p != '\\')
-              continue;
-
-            // We need to keep track of \\ escapings so we don't confuse
-            // them with \", as in "\\".
-            //
-            if (l[i] == '\\' && p == '\\')
-              p = '\0';
-            else
-              p = l[i];
-
-            r += l[i];
-          }
-
-          nl.push_back (r);
-        }
-
-        break;
-      }
-    default:
-      {
-        cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
-             << "option name expected instead of " << t << endl;
-        throw error ();
-      }
+    if (!option_name (t, n))
+    {
+      cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+           << "option name expected instead of " << t << endl;
+      throw error ();
     }
 
-    t = lexer_->next ();
+    if (valid_)
+      nl.push_back (n);
 
     if (t.punctuation () == token::p_or)
       t = lexer_->next ();
@@ -653,8 +692,18 @@ option_def (token& t)
   }
 
   if (valid_)
+  {
     root_->new_edge<names> (*scope_, *o, nl);
 
+    if (required)
+    {
+      constraint x;
+      x.required = true;
+      x.options.push_back (o);
+      dynamic_cast<class_&> (*scope_).constraints ().push_back (x);
+    }
+  }
+
   // initializer
   //
   std::string ev;
@@ -740,6 +789,20 @@ option_def (token& t)
     t = lexer_->next ();
   }
 
+  if (sink && !ev.empty ())
+  {
+    cerr << *path_ << ':' << l << ':' << c << ": error: "
+         << "sink option cannot have an initializer" << endl;
+    throw error ();
+  }
+
+  if (lazy && ev.empty ())
+  {
+    cerr << *path_ << ':' << l << ':' << c << ": error: "
+         << "lazy option requires an initializer" << endl;
+    throw error ();
+  }
+
   if (valid_ && !ev.empty ())
   {
     expression& e (root_->new_node<expression> (*path_, l, c, et, ev));
@@ -866,6 +929,235 @@ option_def (token& t)
   return true;
 }
 
+bool parser::
+constraint_def (token& t)
+{
+  constraint x;
+
+  if (keyword (t, "exclusive", true))
+  {
+    // exclusive-group-def
+    //
+    x.exclusive = true;
+    t = lexer_->next ();
+  }
+  else if (keyword (t, "depends"))
+  {
+    // dependency-def
+    //
+    t = lexer_->next ();
+
+    size_t l (t.line ()), c (t.column ());
+    string n;
+
+    if (!option_name (t, n))
+    {
+      cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+           << "option name expected instead of " << t << endl;
+      throw error ();
+    }
+
+    if (valid_)
+      x.dependent = find_option (n, l, c);
+
+    if (t.punctuation () != token::p_colon)
+    {
+      cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+           << "expected ':' instead of " << t << endl;
+      throw error ();
+    }
+
+    x.required = true;
+    t = lexer_->next ();
+  }
+  else
+    return false;
+
+  option_group (t, x);
+
+  if (valid_)
+    dynamic_cast<class_&> (*scope_).constraints ().push_back (x);
+
+  return true;
+}
+
+void parser::
+option_group (token& t,
+              constraint& x,
+              string const* first,
+              size_t line,
+              size_t column)
+{
+  // option-name-seq
+  //
+  for (;;)
+  {
+    size_t l (t.line ()), c (t.column ());
+    string n;
+
+    if (first != 0)
+    {
+      n = *first;
+      l = line;
+      c = column;
+      first = 0;
+    }
+    else if (!option_name (t, n))
+    {
+      cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+           << "option name expected instead of " << t << endl;
+      throw error ();
+    }
+
+    if (valid_)
+      x.options.push_back (find_option (n, l, c));
+
+    if (t.punctuation () == token::p_or)
+      t = lexer_->next ();
+    else
+      break;
+  }
+
+  if (t.punctuation () != token::p_semi)
+  {
+    cerr << *path_ << ':' << t.line () << ':' << t.column () << ": error: "
+         << "expected ';' instead of " << t << endl;
+    throw error ();
+  }
+}
+
+bool parser::
+option_name (token& t, string& r)
+{
+  switch (t.type ())
+  {
+  case token::t_identifier:
+    {
+      r = t.identifier ();
+      break;
+    }
+  case token::t_string_lit:
+    {
+      // Get rid of '"'.
+      //
+      r.clear ();
+      string const& l (t.literal ());
+      char p ('\0');
+
+      for (size_t i (0), n (l.size ()); i < n; ++i)
+      {
+        if (l[i] == '"' && p != '\\')
+          continue;
+
+        // We need to keep track of \\ escapings so we don't confuse
+        // them with \", as in "\\".
+        //
+        if (l[i] == '\\' && p == '\\')
+          p = '\0';
+        else
+          p = l[i];
+
+        r += l[i];
+      }
+
+      break;
+    }
+  default:
+    return false;
+  }
+
+  t = lexer_->next ();
+  return true;
+}
+
+bool parser::
+keyword (token& t, char const* k, bool group)
+{
+  // The option kind and constraint keywords are only recognized at the
+  // beginning of a class member and are identifiers everywhere else so
+  // that they can still be used as option, namespace, and type names.
+  //
+  if (t.type () != token::t_identifier || t.identifier () != k)
+    return false;
+
+  token n (lexer_->next ());
+
+  bool r (n.punctuation () != token::p_dcolon &&
+          n.type () != token::t_template_expr);
+
+  // If the next token is a name that is directly followed by what can
+  // only follow an option name, then the word is the option type.
+  //
+  if (r)
+  {
+    token x (n);
+    string name;
+
+    if (option_name (x, name))
+    {
+      switch (x.punctuation ())
+      {
+      case token::p_semi:
+      case token::p_or:
+        {
+          r = group && find_option (name) != 0;
+          break;
+        }
+      case token::p_eq:
+      case token::p_lcbrace:
+        {
+          r = false;
+          break;
+        }
+      default:
+        {
+          r = x.type () != token::t_call_expr;
+          break;
+        }
+      }
+
+      lexer_->unget (x);
+    }
+  }
+
+  lexer_->unget (n);
+  return r;
+}
+
+option* parser::
+find_option (string const& n)
+{
+  // Options referenced in a constraint must be defined earlier in the
+  // same class.
+  //
+  for (scope::names_iterator i (scope_->names_begin ());
+       i != scope_->names_end (); ++i)
+  {
+    if (option* o = dynamic_cast<option*> (&i->named ()))
+    {
+      for (names::name_iterator j (i->name_begin ());
+           j != i->name_end (); ++j)
+      {
+        if (*j == n)
+          return o;
+      }
+    }
+  }
+
+  return 0;
+}
+
+option* parser::
+find_option (string const& n, size_t l, size_t c)
+{
+  if (option* o = find_option (n))
+    return o;
+
+  cerr << *path_ << ':' << l << ':' << c << ": error: "
+       << "unknown option '" << n << "'" << endl;
+  throw error ();
+}
+
 bool parser::
 qualified_name (token& t, string& r)
 {
@@ -14,6 +14,7 @@
 
 #include "semantics/elements.hxx"
 #include "semantics/unit.hxx"
+#include "semantics/class.hxx"
 
 class token;
 class lexer;
@@ -51,6 +52,37 @@ private:
   bool
   option_def (token&);
 
+  bool
+  constraint_def (token&);
+
+  void
+  option_group (token&,
+                semantics::constraint&,
+                std::string const* first = 0,
+                std::size_t line = 0,
+                std::size_t column = 0);
+
+  bool
+  option_name (token&, std::string& name);
+
+  // Return true if the token is the contextual keyword rather than the
+  // beginning of a qualified name, such as sink::type or sink<T>, or
+  // the type of an option definition, such as sink --name. If group is
+  // true, then the keyword may also be followed by a list of options,
+  // such as exclusive --a | --b, which is only recognized as such if
+  // the first option is defined earlier in the class.
+  //
+  bool
+  keyword (token&, char const* keyword, bool group = false);
+
+  semantics::option*
+  find_option (std::string const& name, std::size_t line, std::size_t column);
+
+  // As above but return NULL if there is no such option.
+  //
+  semantics::option*
+  find_option (std::string const& name);
+
   bool
   qualified_name (token&, std::string& name);
 
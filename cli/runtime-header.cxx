@@ -11,19 +11,35 @@ void
 generate_runtime_header (context& ctx)
 {
   ostream& os (ctx.os);
+  bool ne (ctx.options.suppress_exceptions ());
 
   if (ctx.options.generate_file_scanner ())
     os << "#include <deque>" << endl;
 
   if (ctx.options.generate_description ())
-    os << "#include <map>" << endl
-       << "#include <vector>" << endl;
+    os << "#include <map>" << endl;
+
+  if (ctx.options.generate_description () ||
+      ctx.options.generate_parse_batch ())
+    os << "#include <vector>" << endl;
+
+  if (ctx.options.generate_parse_batch ())
+  {
+    os << "#include <atomic>" << endl
+       << "#include <thread>" << endl;
+
+    if (!ne)
+      os << "#include <system_error>" << endl;
+  }
 
   os << "#include <iosfwd>" << endl
      << "#include <string>" << endl
-     << "#include <cstddef>" << endl
-     << "#include <exception>" << endl
-     << endl;
+     << "#include <cstddef>" << endl;
+
+  if (!ne)
+    os << "#include <exception>" << endl;
+
+  os << endl;
 
   ctx.cli_open ();
 
@@ -45,137 +61,157 @@ generate_runtime_header (context& ctx)
      << "value v_;"
      << "};";
 
-  // Exceptions.
+  // string_ref
   //
+  if (ctx.options.generate_string_ref ())
+  {
+    string const& os_type (ctx.options.ostream_type ());
 
-  string const& os_type (ctx.options.ostream_type ());
-
-  os << "// Exceptions." << endl
-     << "//" << endl
-     << endl;
+    os << "class string_ref"
+       << "{"
+       << "public:" << endl
+       << "string_ref ();"
+       << "string_ref (const char*);"
+       << "string_ref (const char*, std::size_t);"
+       << "string_ref (const std::string&);"
+       << endl
+       << "const char*" << endl
+       << "data () const;"
+       << endl
+       << "std::size_t" << endl
+       << "size () const;"
+       << endl
+       << "bool" << endl
+       << "empty () const;"
+       << endl
+       << "const char*" << endl
+       << "begin () const;"
+       << endl
+       << "const char*" << endl
+       << "end () const;"
+       << endl
+       << "std::string" << endl
+       << "str () const;"
+       << endl
+       << "private:" << endl
+       << "const char* data_;"
+       << "std::size_t size_;"
+       << "};";
 
-  os << "class exception: public std::exception"
-     << "{"
-     << "public:" << endl
-     << "virtual void" << endl
-     << "print (" << os_type << "&) const = 0;"
-     << "};";
+    os << "bool" << endl
+       << "operator== (const string_ref&, const string_ref&);"
+       << endl
+       << "bool" << endl
+       << "operator!= (const string_ref&, const string_ref&);"
+       << endl
+       << "bool" << endl
+       << "operator< (const string_ref&, const string_ref&);"
+       << endl
+       << os_type << "&" << endl
+       << "operator<< (" << os_type << "&, const string_ref&);"
+       << endl;
+  }
 
-  os << os_type << "&" << endl
-     << "operator<< (" << os_type << "&, const exception&);"
-     << endl;
+  // Exceptions or, if they are suppressed, the error class.
+  //
+  string const& os_type (ctx.options.ostream_type ());
 
-  os << "class unknown_option: public exception"
-     << "{"
-     << "public:" << endl
-     << "virtual" << endl
-     << "~unknown_option () throw ();"
-     << endl
-     << "unknown_option (const std::string& option);"
-     << endl
-     << "const std::string&" << endl
-     << "option () const;"
-     << endl
-     << "virtual void" << endl
-     << "print (" << os_type << "&) const;"
-     << endl
-     << "virtual const char*" << endl
-     << "what () const throw ();"
-     << endl
-     << "private:" << endl
-     << "std::string option_;"
-     << "};";
+  if (ne)
+  {
+    os << "// Error reporting without exceptions." << endl
+       << "//" << endl
+       << endl;
 
-  os << "class unknown_argument: public exception"
-     << "{"
-     << "public:" << endl
-     << "virtual" << endl
-     << "~unknown_argument () throw ();"
-     << endl
-     << "unknown_argument (const std::string& argument);"
-     << endl
-     << "const std::string&" << endl
-     << "argument () const;"
-     << endl
-     << "virtual void" << endl
-     << "print (" << os_type << "&) const;"
-     << endl
-     << "virtual const char*" << endl
-     << "what () const throw ();"
-     << endl
-     << "private:" << endl
-     << "std::string argument_;"
-     << "};";
+    os << "class error"
+       << "{"
+       << "public:" << endl
+       << "enum code_type"
+       << "{"
+       << "none," << endl
+       << "unknown_option," << endl
+       << "unknown_argument," << endl
+       << "missing_value," << endl
+       << "invalid_value," << endl
+       << "eos_reached," << endl
+       << "file_io_failure," << endl
+       << "unmatched_quote," << endl
+       << "invalid_buffer," << endl
+       << "missing_option," << endl
+       << "option_conflict" << endl
+       << "};"
+       << "error (code_type code = none," << endl
+       << "const std::string& subject = std::string ()," << endl
+       << "const std::string& value = std::string ());"
+       << endl
+       << "code_type" << endl
+       << "code () const;"
+       << endl
+       << "// Option name for unknown_option, missing_value," << endl
+       << "// invalid_value, and option_conflict. Option names" << endl
+       << "// separated with '|' for missing_option." << endl
+       << "//" << endl
+       << "const std::string&" << endl
+       << "option () const;"
+       << endl
+       << "// Argument for unknown_argument and unmatched_quote." << endl
+       << "//" << endl
+       << "const std::string&" << endl
+       << "argument () const;"
+       << endl
+       << "// File name for file_io_failure." << endl
+       << "//" << endl
+       << "const std::string&" << endl
+       << "file () const;"
+       << endl
+       << "// Option value for invalid_value and the other option" << endl
+       << "// for option_conflict." << endl
+       << "//" << endl
+       << "const std::string&" << endl
+       << "value () const;"
+       << endl
+       << "void" << endl
+       << "print (" << os_type << "&) const;"
+       << endl
+       << "const char*" << endl
+       << "what () const;"
+       << endl
+       << "private:" << endl
+       << "code_type code_;"
+       << "std::string subject_;"
+       << "std::string value_;"
+       << "};";
 
-  os << "class missing_value: public exception"
-     << "{"
-     << "public:" << endl
-     << "virtual" << endl
-     << "~missing_value () throw ();"
-     << endl
-     << "missing_value (const std::string& option);"
-     << endl
-     << "const std::string&" << endl
-     << "option () const;"
-     << endl
-     << "virtual void" << endl
-     << "print (" << os_type << "&) const;"
-     << endl
-     << "virtual const char*" << endl
-     << "what () const throw ();"
-     << endl
-     << "private:" << endl
-     << "std::string option_;"
-     << "};";
+    os << os_type << "&" << endl
+       << "operator<< (" << os_type << "&, const error&);"
+       << endl;
+  }
+  else
+  {
+    os << "// Exceptions." << endl
+       << "//" << endl
+       << endl;
 
-  os << "class invalid_value: public exception"
-     << "{"
-     << "public:" << endl
-     << "virtual" << endl
-     << "~invalid_value () throw ();"
-     << endl
-     << "invalid_value (const std::string& option," << endl
-     << "const std::string& value);"
-     << endl
-     << "const std::string&" << endl
-     << "option () const;"
-     << endl
-     << "const std::string&" << endl
-     << "value () const;"
-     << endl
-     << "virtual void" << endl
-     << "print (" << os_type << "&) const;"
-     << endl
-     << "virtual const char*" << endl
-     << "what () const throw ();"
-     << endl
-     << "private:" << endl
-     << "std::string option_;"
-     << "std::string value_;"
-     << "};";
+    os << "class exception: public std::exception"
+       << "{"
+       << "public:" << endl
+       << "virtual void" << endl
+       << "print (" << os_type << "&) const = 0;"
+       << "};";
 
-  os << "class eos_reached: public exception"
-     << "{"
-     << "public:" << endl
-     << "virtual void" << endl
-     << "print (" << os_type << "&) const;"
-     << endl
-     << "virtual const char*" << endl
-     << "what () const throw ();"
-     << "};";
+    os << os_type << "&" << endl
+       << "operator<< (" << os_type << "&, const exception&);"
+       << endl;
 
-  if (ctx.options.generate_file_scanner ())
-  {
-    os << "class file_io_failure: public exception"
+    os << "class unknown_option: public exception"
        << "{"
        << "public:" << endl
        << "virtual" << endl
-       << "~file_io_failure () throw ();"
+       << "~unknown_option () throw ();"
        << endl
-       << "file_io_failure (const std::string& file);"
+       << "unknown_option (const std::string& option);"
        << endl
        << "const std::string&" << endl
-       << "file () const;"
+       << "option () const;"
        << endl
        << "virtual void" << endl
        << "print (" << os_type << "&) const;"
@@ -184,16 +220,16 @@ generate_runtime_header (context& ctx)
        << "what () const throw ();"
        << endl
        << "private:" << endl
-       << "std::string file_;"
+       << "std::string option_;"
        << "};";
 
-    os << "class unmatched_quote: public exception"
+    os << "class unknown_argument: public exception"
        << "{"
        << "public:" << endl
        << "virtual" << endl
-       << "~unmatched_quote () throw ();"
+       << "~unknown_argument () throw ();"
        << endl
-       << "unmatched_quote (const std::string& argument);"
+       << "unknown_argument (const std::string& argument);"
        << endl
        << "const std::string&" << endl
        << "argument () const;"
@@ -207,6 +243,174 @@ generate_runtime_header (context& ctx)
        << "private:" << endl
        << "std::string argument_;"
        << "};";
+
+    os << "class missing_value: public exception"
+       << "{"
+       << "public:" << endl
+       << "virtual" << endl
+       << "~missing_value () throw ();"
+       << endl
+       << "missing_value (const std::string& option);"
+       << endl
+       << "const std::string&" << endl
+       << "option () const;"
+       << endl
+       << "virtual void" << endl
+       << "print (" << os_type << "&) const;"
+       << endl
+       << "virtual const char*" << endl
+       << "what () const throw ();"
+       << endl
+       << "private:" << endl
+       << "std::string option_;"
+       << "};";
+
+    os << "class invalid_value: public exception"
+       << "{"
+       << "public:" << endl
+       << "virtual" << endl
+       << "~invalid_value () throw ();"
+       << endl
+       << "invalid_value (const std::string& option," << endl
+       << "const std::string& value);"
+       << endl
+       << "const std::string&" << endl
+       << "option () const;"
+       << endl
+       << "const std::string&" << endl
+       << "value () const;"
+       << endl
+       << "virtual void" << endl
+       << "print (" << os_type << "&) const;"
+       << endl
+       << "virtual const char*" << endl
+       << "what () const throw ();"
+       << endl
+       << "private:" << endl
+       << "std::string option_;"
+       << "std::string value_;"
+       << "};";
+
+    os << "class eos_reached: public exception"
+       << "{"
+       << "public:" << endl
+       << "virtual void" << endl
+       << "print (" << os_type << "&) const;"
+       << endl
+       << "virtual const char*" << endl
+       << "what () const throw ();"
+       << "};";
+
+    // Constraint violations. For a group of options, option() contains
+    // their names separated with '|'.
+    //
+    os << "class missing_option: public exception"
+       << "{"
+       << "public:" << endl
+       << "virtual" << endl
+       << "~missing_option () throw ();"
+       << endl
+       << "missing_option (const std::string& option);"
+       << endl
+       << "const std::string&" << endl
+       << "option () const;"
+       << endl
+       << "virtual void" << endl
+       << "print (" << os_type << "&) const;"
+       << endl
+       << "virtual const char*" << endl
+       << "what () const throw ();"
+       << endl
+       << "private:" << endl
+       << "std::string option_;"
+       << "};";
+
+    os << "class option_conflict: public exception"
+       << "{"
+       << "public:" << endl
+       << "virtual" << endl
+       << "~option_conflict () throw ();"
+       << endl
+       << "option_conflict (const std::string& option," << endl
+       << "const std::string& other);"
+       << endl
+       << "const std::string&" << endl
+       << "option () const;"
+       << endl
+       << "const std::string&" << endl
+       << "other () const;"
+       << endl
+       << "virtual void" << endl
+       << "print (" << os_type << "&) const;"
+       << endl
+       << "virtual const char*" << endl
+       << "what () const throw ();"
+       << endl
+       << "private:" << endl
+       << "std::string option_;"
+       << "std::string other_;"
+       << "};";
+
+    if (ctx.options.generate_file_scanner () ||
+        ctx.options.generate_stream_scanner ())
+    {
+      os << "class file_io_failure: public exception"
+         << "{"
+         << "public:" << endl
+         << "virtual" << endl
+         << "~file_io_failure () throw ();"
+         << endl
+         << "file_io_failure (const std::string& file);"
+         << endl
+         << "const std::string&" << endl
+         << "file () const;"
+         << endl
+         << "virtual void" << endl
+         << "print (" << os_type << "&) const;"
+         << endl
+         << "virtual const char*" << endl
+         << "what () const throw ();"
+         << endl
+         << "private:" << endl
+         << "std::string file_;"
+         << "};";
+    }
+
+    if (ctx.options.generate_file_scanner () ||
+        ctx.options.generate_string_scanner ())
+    {
+      os << "class unmatched_quote: public exception"
+         << "{"
+         << "public:" << endl
+         << "virtual" << endl
+         << "~unmatched_quote () throw ();"
+         << endl
+         << "unmatched_quote (const std::string& argument);"
+         << endl
+         << "const std::string&" << endl
+         << "argument () const;"
+         << endl
+         << "virtual void" << endl
+         << "print (" << os_type << "&) const;"
+         << endl
+         << "virtual const char*" << endl
+         << "what () const throw ();"
+         << endl
+         << "private:" << endl
+         << "std::string argument_;"
+         << "};";
+    }
+
+    if (ctx.options.generate_buffer_scanners ())
+      os << "class invalid_buffer: public exception"
+         << "{"
+         << "public:" << endl
+         << "virtual void" << endl
+         << "print (" << os_type << "&) const;"
+         << endl
+         << "virtual const char*" << endl
+         << "what () const throw ();"
+         << "};";
   }
 
   // scanner
@@ -227,8 +431,27 @@ generate_runtime_header (context& ctx)
      << "next () = 0;"
      << endl
      << "virtual void" << endl
-     << "skip () = 0;"
-     << "};";
+     << "skip () = 0;";
+
+  // Scanners record the first error that occurred instead of throwing.
+  // The scanner functions then return false or NULL.
+  //
+  if (ne)
+    os << endl
+       << "typedef " << ctx.cli << "::error error_type;"
+       << endl
+       << "const error_type&" << endl
+       << "error () const;"
+       << endl
+       << "// Record the error unless one has already been recorded." << endl
+       << "//" << endl
+       << "void" << endl
+       << "fail (const error_type&);"
+       << endl
+       << "private:" << endl
+       << "error_type error_;";
+
+  os << "};";
 
   // argv_scanner
   //
@@ -238,6 +461,9 @@ generate_runtime_header (context& ctx)
      << "argv_scanner (int& argc, char** argv, bool erase = false);"
      << "argv_scanner (int start, int& argc, char** argv, bool erase = false);"
      << endl
+     << "virtual" << endl
+     << "~argv_scanner ();"
+     << endl
      << "int" << endl
      << "end () const;"
      << endl
@@ -253,17 +479,83 @@ generate_runtime_header (context& ctx)
      << "virtual void" << endl
      << "skip ();"
      << endl
+     << "// When erasing, move the unscanned arguments down and update" << endl
+     << "// argc. This is done automatically once the end of arguments" << endl
+     << "// is reached and when the scanner is destroyed. Call it to" << endl
+     << "// examine argc and argv while the scanner is still in use, for" << endl
+     << "// example, after parsing stopped at an unknown argument." << endl
+     << "//" << endl
+     << "void" << endl
+     << "compact ();"
+     << endl
+     << "private:" << endl
+     << "argv_scanner (const argv_scanner&);"
+     << "argv_scanner& operator= (const argv_scanner&);"
+     << endl
      << "private:" << endl
      << "int i_;"
+     << "int j_;" // Next argv_ slot for retained arguments when erasing.
      << "int& argc_;"
      << "char** argv_;"
      << "bool erase_;"
      << "};";
 
+  // bundle_scanner
+  //
+  if (ctx.options.bundle_short_options ())
+  {
+    os << "// Scan a bundle of single-character options, such as -xzf," << endl
+       << "// from the next argument of the underlying scanner. Each" << endl
+       << "// option is presented by its -c name. The rest of the" << endl
+       << "// bundle after an option, if any, is presented as its" << endl
+       << "// value and otherwise the value is scanned from the" << endl
+       << "// underlying scanner. The bundle is scanned in place." << endl
+       << "//" << endl
+       << "class bundle_scanner: public scanner"
+       << "{"
+       << "public:" << endl
+       << "bundle_scanner (scanner&);"
+       << endl
+       << "// The current option character." << endl
+       << "//" << endl
+       << "char" << endl
+       << "option () const;"
+       << endl
+       << "// Move to the next option in the bundle. Return false if" << endl
+       << "// there are no more options or the rest of the bundle has" << endl
+       << "// been scanned as a value." << endl
+       << "//" << endl
+       << "bool" << endl
+       << "advance ();"
+       << endl
+       << "virtual bool" << endl
+       << "more ();"
+       << endl
+       << "virtual const char*" << endl
+       << "peek ();"
+       << endl
+       << "virtual const char*" << endl
+       << "next ();"
+       << endl
+       << "virtual void" << endl
+       << "skip ();"
+       << endl
+       << "private:" << endl
+       << "scanner& s_;"
+       << "const char* p_;" // Current option character.
+       << "bool c_;" // Bundle argument consumed from the underlying scanner.
+       << "bool v_;" // Option name scanned, the value is next.
+       << "bool d_;" // Done with the bundle, delegate to the underlying one.
+       << "char n_[3];" // Current option name.
+       << "};";
+  }
+
   // argv_file_scanner
   //
   if (ctx.options.generate_file_scanner ())
   {
+    bool fc (ctx.options.generate_file_cache ());
+
     os << "class argv_file_scanner: public argv_scanner"
        << "{"
        << "public:" << endl
@@ -312,30 +604,227 @@ generate_runtime_header (context& ctx)
        << endl
        << "virtual void" << endl
        << "skip ();"
+       << endl;
+
+    if (fc)
+      os << "// Cache pre-tokenized options files in dir or, if it is" << endl
+         << "// empty, next to the options files." << endl
+         << "//" << endl
+         << "void" << endl
+         << "cache (const std::string& dir);"
+         << endl;
+
+    os << "private:" << endl
+       << "void" << endl
+       << "init ();"
+       << endl
+       << "static unsigned char" << endl
+       << "hash (const char*, std::size_t);"
        << endl
-       << "private:" << endl
        << "const option_info*" << endl
        << "find (const char*) const;"
        << endl
        << "void" << endl
        << "load (const std::string& file);"
        << endl
-       << "typedef argv_scanner base;"
+       << "static bool" << endl
+       << "read (std::istream&, std::string&);"
+       << endl
+       << "void" << endl
+       << "process (const char* a, const char* v);"
+       << endl;
+
+    if (fc)
+      os << "bool" << endl
+         << "load_cache (const std::string& file, const std::string& key);"
+         << endl
+         << "static bool" << endl
+         << "cache_key (const std::string& file, std::string& key);"
+         << endl
+         << "std::string" << endl
+         << "cache_file (const std::string& file) const;"
+         << endl;
+
+    os << "typedef argv_scanner base;"
        << endl
        << "const std::string option_;"
        << "option_info option_info_;"
        << "const option_info* options_;"
        << "std::size_t options_count_;"
        << endl
-       << "std::string hold_;"
-       << "std::deque<std::string> args_;";
+       << "// Option names index: the longest name and a bit per name" << endl
+       << "// hash value that allow rejecting most arguments without" << endl
+       << "// comparing them to every name." << endl
+       << "//" << endl
+       << "std::size_t max_size_;"
+       << "unsigned char filter_[32];"
+       << endl
+       << "std::deque<std::string> hold_;" // Options files content.
+       << "std::deque<const char*> args_;";
 
     if (!ctx.opt_sep.empty ())
       os << "bool skip_;";
 
+    if (fc)
+      os << endl
+         << "bool cache_;"
+         << "std::string cache_dir_;";
+
     os << "};";
   }
 
+  // string_scanner
+  //
+  if (ctx.options.generate_string_scanner ())
+  {
+    os << "// Scan arguments from a command line string. The string is" << endl
+       << "// tokenized in place as the arguments are scanned and the" << endl
+       << "// returned arguments point into it." << endl
+       << "//" << endl
+       << "class string_scanner: public scanner"
+       << "{"
+       << "public:" << endl
+       << "string_scanner (char* s);"
+       << endl
+       << "virtual bool" << endl
+       << "more ();"
+       << endl
+       << "virtual const char*" << endl
+       << "peek ();"
+       << endl
+       << "virtual const char*" << endl
+       << "next ();"
+       << endl
+       << "virtual void" << endl
+       << "skip ();"
+       << endl
+       << "private:" << endl
+       << "char* p_;" // Next unscanned character.
+       << "const char* a_;" // Scanned argument or NULL.
+       << "};";
+  }
+
+  // nul_scanner and length_prefix_scanner
+  //
+  if (ctx.options.generate_buffer_scanners ())
+  {
+    os << "// Scan the [b, b + n) buffer of NUL-terminated arguments, as" << endl
+       << "// produced, for example, by find -print0. The returned" << endl
+       << "// arguments point into the buffer." << endl
+       << "//" << endl
+       << "class nul_scanner: public scanner"
+       << "{"
+       << "public:" << endl
+       << "nul_scanner (const char* b, std::size_t n);"
+       << endl
+       << "virtual bool" << endl
+       << "more ();"
+       << endl
+       << "virtual const char*" << endl
+       << "peek ();"
+       << endl
+       << "virtual const char*" << endl
+       << "next ();"
+       << endl
+       << "virtual void" << endl
+       << "skip ();"
+       << endl
+       << "private:" << endl
+       << "const char* p_;" // Next argument.
+       << "const char* l_;" // Its terminating NUL or NULL if not yet found.
+       << "const char* e_;"
+       << "};";
+
+    os << "// Scan the [b, b + n) buffer of arguments each preceded by its" << endl
+       << "// size as a 4-byte little-endian integer and followed by NUL." << endl
+       << "// The returned arguments point into the buffer. Since they" << endl
+       << "// are returned as C strings, an argument that contains NUL" << endl
+       << "// is reported as an invalid buffer." << endl
+       << "//" << endl
+       << "class length_prefix_scanner: public scanner"
+       << "{"
+       << "public:" << endl
+       << "length_prefix_scanner (const char* b, std::size_t n);"
+       << endl
+       << "virtual bool" << endl
+       << "more ();"
+       << endl
+       << "virtual const char*" << endl
+       << "peek ();"
+       << endl
+       << "virtual const char*" << endl
+       << "next ();"
+       << endl
+       << "virtual void" << endl
+       << "skip ();"
+       << endl
+       << "// Size of the current argument, that is, the one returned by" << endl
+       << "// the last call to peek() or next(). Note that more(), which" << endl
+       << "// is called by peek(), moves on to the next argument once the" << endl
+       << "// current one has been consumed with next() or skip()." << endl
+       << "//" << endl
+       << "std::size_t" << endl
+       << "size () const;"
+       << endl
+       << "private:" << endl
+       << "const char* p_;" // Next argument's size.
+       << "const char* e_;"
+       << "const char* a_;" // Scanned argument or NULL.
+       << "std::size_t n_;"
+       << "};";
+  }
+
+  // stream_scanner
+  //
+  if (ctx.options.generate_stream_scanner ())
+  {
+    os << "// Scan arguments separated by the delimiter from the stream" << endl
+       << "// which is read in chunk_size pieces. If the delimiter is" << endl
+       << "// newline, then a trailing carriage return is also removed." << endl
+       << "// A string returned by peek() or next() remains valid until" << endl
+       << "// two more arguments have been scanned. As a result, option" << endl
+       << "// values of the string_ref type as well as string_ref values" << endl
+       << "// passed to sink functions must be copied if they are needed" << endl
+       << "// after that." << endl
+       << "//" << endl
+       << "class stream_scanner: public scanner"
+       << "{"
+       << "public:" << endl
+       << "stream_scanner (std::istream&," << endl
+       << "char delimiter = '\\n'," << endl
+       << "std::size_t chunk_size = 65536);"
+       << endl
+       << "virtual bool" << endl
+       << "more ();"
+       << endl
+       << "virtual const char*" << endl
+       << "peek ();"
+       << endl
+       << "virtual const char*" << endl
+       << "next ();"
+       << endl
+       << "virtual void" << endl
+       << "skip ();"
+       << endl
+       << "private:" << endl
+       << "bool" << endl
+       << "fill ();"
+       << endl
+       << "private:" << endl
+       << "std::istream& is_;"
+       << "char delimiter_;"
+       << "std::size_t chunk_size_;"
+       << endl
+       << "std::string buf_;"
+       << "std::size_t p_;" // Next unscanned character in buf_.
+       << "std::size_t e_;" // End of data in buf_.
+       << endl
+       << "std::string args_[3];" // Scanned arguments, round-robin.
+       << "std::size_t i_;" // Current argument in args_.
+       << "bool scanned_;" // Current argument has been scanned.
+       << "};";
+  }
+
   // Option description.
   //
   if (ctx.options.generate_description ())
@@ -396,5 +885,324 @@ generate_runtime_header (context& ctx)
      << "struct parser;"
      << endl;
 
+  // Sink option data member.
+  //
+  os << "// Data member of a sink option. If func is not NULL, then it" << endl
+     << "// is called with each option value, as it is parsed, and arg." << endl
+     << "//" << endl
+     << "template <typename X>" << endl
+     << "struct sink"
+     << "{"
+     << "sink (): func (0), arg (0) {}"
+     << endl
+     << "void (*func) (const X&, void*);"
+     << "void* arg;"
+     << "};";
+
+  // Packed bool option values and specifier flags (--pack-flags) as
+  // well as the presence masks of the options referenced in constraints.
+  // Since constraints are only known to the options files that use them,
+  // this is always generated.
+  //
+  os << "// Reference to a single bit in flag_set." << endl
+     << "//" << endl
+     << "class flag_ref"
+     << "{"
+     << "public:" << endl
+     << "flag_ref (unsigned char& b, unsigned char m): b_ (b), m_ (m) {}"
+     << endl
+     << "operator bool () const {return (b_ & m_) != 0;}"
+     << endl
+     << "flag_ref&" << endl
+     << "operator= (bool v)"
+     << "{"
+     << "b_ = static_cast<unsigned char> (v ? b_ | m_ : b_ & ~m_);"
+     << "return *this;"
+     << "}"
+     << "flag_ref&" << endl
+     << "operator= (const flag_ref& x)"
+     << "{"
+     << "return *this = static_cast<bool> (x);"
+     << "}"
+     << "private:" << endl
+     << "unsigned char& b_;"
+     << "unsigned char m_;"
+     << "};";
+
+  os << "// Fixed-size set of N bits. The any() and all() functions" << endl
+     << "// test the bits against a mask in a single pass over the" << endl
+     << "// N/8 bytes." << endl
+     << "//" << endl
+     << "template <std::size_t N>" << endl
+     << "class flag_set"
+     << "{"
+     << "public:" << endl
+     << "flag_set () {reset ();}"
+     << endl
+     << "bool" << endl
+     << "operator[] (std::size_t i) const"
+     << "{"
+     << "return (b_[i / 8] & (1U << (i % 8))) != 0;"
+     << "}"
+     << "flag_ref" << endl
+     << "operator[] (std::size_t i)"
+     << "{"
+     << "return flag_ref (b_[i / 8], " <<
+    "static_cast<unsigned char> (1U << (i % 8)));"
+     << "}"
+     << "bool" << endl
+     << "test (std::size_t i) const {return (*this)[i];}"
+     << endl
+     << "flag_set&" << endl
+     << "set (std::size_t i, bool v = true) {(*this)[i] = v; return *this;}"
+     << endl
+     << "void" << endl
+     << "reset ()"
+     << "{"
+     << "for (std::size_t i (0); i != size_; ++i)" << endl
+     << "b_[i] = 0;"
+     << "}";
+
+  // The table-driven parser sets the bits through the option_ref
+  // pointers (see runtime-source.cxx).
+  //
+  if (ctx.tabular)
+    os << "unsigned char*" << endl
+       << "data () {return b_;}"
+       << endl;
+
+  os << "// Return true if any/all of the mask bits are set." << endl
+     << "//" << endl
+     << "bool" << endl
+     << "any (const flag_set& m) const"
+     << "{"
+     << "for (std::size_t i (0); i != size_; ++i)" << endl
+     << "if ((b_[i] & m.b_[i]) != 0)" << endl
+     << "return true;"
+     << endl
+     << "return false;"
+     << "}"
+     << "bool" << endl
+     << "all (const flag_set& m) const"
+     << "{"
+     << "for (std::size_t i (0); i != size_; ++i)" << endl
+     << "if ((b_[i] & m.b_[i]) != m.b_[i])" << endl
+     << "return false;"
+     << endl
+     << "return true;"
+     << "}"
+     << "// Return the number of mask bits that are set." << endl
+     << "//" << endl
+     << "std::size_t" << endl
+     << "count (const flag_set& m) const"
+     << "{"
+     << "std::size_t n (0);"
+     << endl
+     << "for (std::size_t i (0); i != size_; ++i)"
+     << "{"
+     << "for (unsigned int b (b_[i] & m.b_[i]); b != 0; b &= b - 1)" << endl
+     << "++n;"
+     << "}"
+     << "return n;"
+     << "}"
+     << "// Return the index of the first mask bit at or after i that" << endl
+     << "// is set or N if there is none." << endl
+     << "//" << endl
+     << "std::size_t" << endl
+     << "find (const flag_set& m, std::size_t i = 0) const"
+     << "{"
+     << "for (; i != N; ++i)"
+     << "{"
+     << "if (m[i] && (*this)[i])" << endl
+     << "return i;"
+     << "}"
+     << "return N;"
+     << "}"
+     << "bool" << endl
+     << "operator== (const flag_set& x) const"
+     << "{"
+     << "for (std::size_t i (0); i != size_; ++i)" << endl
+     << "if (b_[i] != x.b_[i])" << endl
+     << "return false;"
+     << endl
+     << "return true;"
+     << "}"
+     << "bool" << endl
+     << "operator!= (const flag_set& x) const {return !(*this == x);}"
+     << endl
+     << "private:" << endl
+     << "static const std::size_t size_ = (N + 7) / 8;"
+     << "unsigned char b_[size_];"
+     << "};";
+
+  // Table-driven parsing support.
+  //
+  if (ctx.tabular)
+  {
+    os << "// Constant description of an option in a lookup table. The" << endl
+       << "// index selects the option in the parsing code of the class" << endl
+       << "// and the type selects the value parser." << endl
+       << "//" << endl
+       << "struct option_desc"
+       << "{"
+       << "enum value_type"
+       << "{"
+       << "bool_value," << endl
+       << "string_value," << endl
+       << "int_value," << endl
+       << "unsigned_int_value," << endl
+       << "long_value," << endl
+       << "unsigned_long_value," << endl
+       << "double_value," << endl
+       << "string_vector_value," << endl
+       << "other_value" << endl
+       << "};"
+       << "const char* name;"
+       << "std::size_t size;"
+       << "unsigned short index;"
+       << "unsigned char type;"
+       << "unsigned short flag;     // Packed flag bit." << endl
+       << "unsigned short presence; // Presence bit." << endl
+       << "};";
+
+    os << "// Location of the option value and the associated state in" << endl
+       << "// the options object. The pointers are null if the option" << endl
+       << "// has no such state." << endl
+       << "//" << endl
+       << "struct option_ref"
+       << "{"
+       << "void* value;"
+       << "bool* specifier;"
+       << "bool* lazy;"
+       << "unsigned char* flags;    // Packed flag set." << endl
+       << "unsigned char* presence; // Presence flag set." << endl
+       << endl
+       << "// Value parser for option_desc::other_value." << endl
+       << "//" << endl
+       << "void (*parse) (void*, bool&, scanner&);"
+       << "};";
+
+    os << "void" << endl
+       << "parse_option (const option_desc&, const option_ref&, scanner&);"
+       << endl;
+  }
+
+  // Batch parsing. Being a template, it has to be defined in the header.
+  //
+  if (ctx.options.generate_parse_batch ())
+  {
+    os << "// Result of parsing one command line with parse_batch()." << endl
+       << "//" << endl
+       << "template <typename O>" << endl
+       << "struct parse_result"
+       << "{"
+       << "O options;"
+       << endl;
+
+    if (ne)
+      os << "// Error code is error::none if parsing succeeded." << endl
+         << "//" << endl
+         << ctx.cli << "::error error;";
+    else
+      os << "// Null if parsing succeeded." << endl
+         << "//" << endl
+         << "std::exception_ptr error;";
+
+    os << "};";
+
+    os << "// Parse the command lines in the [begin, end) random access" << endl
+       << "// range, each being a sequence of std::string arguments (not" << endl
+       << "// including the program name), into the options class O using" << endl
+       << "// the specified number of threads (0 means one per hardware" << endl
+       << "// thread). The results are returned in the same order. The" << endl
+       << "// calling thread also participates in parsing." << endl
+       << "//" << endl
+       << "template <typename O, typename I>" << endl
+       << "std::vector<parse_result<O> >" << endl
+       << "parse_batch (I begin," << endl
+       << "I end," << endl
+       << "unsigned int threads = 0," << endl
+       << "unknown_mode option = unknown_mode::fail," << endl
+       << "unknown_mode argument = unknown_mode::stop)"
+       << "{"
+       << "std::vector<parse_result<O> > r (" << endl
+       << "static_cast<std::size_t> (end - begin));"
+       << "std::size_t n (r.size ());"
+       << endl
+       << "if (threads == 0)" << endl
+       << "threads = std::thread::hardware_concurrency ();"
+       << endl
+       << "if (threads == 0)" << endl
+       << "threads = 1;"
+       << endl
+       << "if (threads > n)" << endl
+       << "threads = static_cast<unsigned int> (n);"
+       << endl
+       << "// Each thread claims the next unparsed command line so that" << endl
+       << "// the work is balanced regardless of the line lengths." << endl
+       << "//" << endl
+       << "std::atomic<std::size_t> next (0);"
+       << endl
+       << "auto work = [&r, &next, n, begin, option, argument] ()"
+       << "{"
+       << "std::vector<char*> argv;"
+       << endl
+       << "for (std::size_t i;" << endl
+       << "(i = next.fetch_add (1, std::memory_order_relaxed)) < n;)"
+       << "{"
+       << "argv.clear ();"
+       << endl
+       << "for (const std::string& a: begin[i])" << endl
+       << "argv.push_back (const_cast<char*> (a.c_str ()));"
+       << endl
+       << "argv.push_back (0);"
+       << endl
+       << "int argc (static_cast<int> (argv.size () - 1));"
+       << "argv_scanner s (0, argc, argv.data ());"
+       << "parse_result<O>& x (r[i]);"
+       << endl;
+
+    if (ne)
+      os << "x.options = O (s, option, argument);"
+         << "x.error = s.error ();";
+    else
+      os << "try"
+         << "{"
+         << "x.options = O (s, option, argument);"
+         << "}"
+         << "catch (...)"
+         << "{"
+         << "x.error = std::current_exception ();"
+         << "}";
+
+    os << "}"
+       << "};"
+       << "std::vector<std::thread> ts;"
+       << endl;
+
+    // If we fail to start a thread, make do with those we have.
+    //
+    if (ne)
+      os << "for (unsigned int i (1); i < threads; ++i)" << endl
+         << "ts.emplace_back (work);";
+    else
+      os << "try"
+         << "{"
+         << "for (unsigned int i (1); i < threads; ++i)" << endl
+         << "ts.emplace_back (work);"
+         << "}"
+         << "catch (const std::system_error&)"
+         << "{"
+         << "}";
+
+    os << "work ();"
+       << endl
+       << "for (std::thread& t: ts)" << endl
+       << "t.join ();"
+       << endl
+       << "return r;"
+       << "}";
+  }
+
   ctx.cli_close ();
 }
@@ -13,6 +13,7 @@ generate_runtime_inline (context& ctx)
   ostream& os (ctx.os);
   string const& inl (ctx.inl);
   string const& os_type (ctx.options.ostream_type ());
+  bool ne (ctx.options.suppress_exceptions ());
 
   ctx.cli_open ();
 
@@ -27,129 +28,339 @@ generate_runtime_inline (context& ctx)
      << "{"
      << "}";
 
-  // exception
+  // string_ref
   //
-  os << "// exception" << endl
-     << "//" << endl
-
-     << inl << os_type << "&" << endl
-     << "operator<< (" << os_type << "& os, const exception& e)"
-     << "{"
-     << "e.print (os);"
-     << "return os;"
-     << "}";
+  if (ctx.options.generate_string_ref ())
+  {
+    os << "// string_ref" << endl
+       << "//" << endl
 
-  // unknown_option
-  //
-  os << "// unknown_option" << endl
-     << "//" << endl
+       << inl << "string_ref::" << endl
+       << "string_ref ()" << endl
+       << ": data_ (\"\"), size_ (0)"
+       << "{"
+       << "}"
 
-     << inl << "unknown_option::" << endl
-     << "unknown_option (const std::string& option)" << endl
-     << ": option_ (option)"
-     << "{"
-     << "}"
+       << inl << "string_ref::" << endl
+       << "string_ref (const char* s)" << endl
+       << ": data_ (s), size_ (std::char_traits<char>::length (s))"
+       << "{"
+       << "}"
 
-     << inl << "const std::string& unknown_option::" << endl
-     << "option () const"
-     << "{"
-     << "return option_;"
-     << "}";
+       << inl << "string_ref::" << endl
+       << "string_ref (const char* s, std::size_t n)" << endl
+       << ": data_ (s), size_ (n)"
+       << "{"
+       << "}"
 
-  // unknown_argument
-  //
-  os << "// unknown_argument" << endl
-     << "//" << endl
+       << inl << "string_ref::" << endl
+       << "string_ref (const std::string& s)" << endl
+       << ": data_ (s.c_str ()), size_ (s.size ())"
+       << "{"
+       << "}"
 
-     << inl << "unknown_argument::" << endl
-     << "unknown_argument (const std::string& argument)" << endl
-     << ": argument_ (argument)"
-     << "{"
-     << "}"
+       << inl << "const char* string_ref::" << endl
+       << "data () const"
+       << "{"
+       << "return data_;"
+       << "}"
 
-     << inl << "const std::string& unknown_argument::" << endl
-     << "argument () const"
-     << "{"
-     << "return argument_;"
-     << "}";
+       << inl << "std::size_t string_ref::" << endl
+       << "size () const"
+       << "{"
+       << "return size_;"
+       << "}"
 
-  // missing_value
-  //
-  os << "// missing_value" << endl
-     << "//" << endl
+       << inl << "bool string_ref::" << endl
+       << "empty () const"
+       << "{"
+       << "return size_ == 0;"
+       << "}"
 
-     << inl << "missing_value::" << endl
-     << "missing_value (const std::string& option)" << endl
-     << ": option_ (option)"
-     << "{"
-     << "}"
+       << inl << "const char* string_ref::" << endl
+       << "begin () const"
+       << "{"
+       << "return data_;"
+       << "}"
 
-     << inl << "const std::string& missing_value::" << endl
-     << "option () const"
-     << "{"
-     << "return option_;"
-     << "}";
+       << inl << "const char* string_ref::" << endl
+       << "end () const"
+       << "{"
+       << "return data_ + size_;"
+       << "}"
 
-  // invalid_value
-  //
-  os << "// invalid_value" << endl
-     << "//" << endl
+       << inl << "std::string string_ref::" << endl
+       << "str () const"
+       << "{"
+       << "return std::string (data_, size_);"
+       << "}"
 
-     << inl << "invalid_value::" << endl
-     << "invalid_value (const std::string& option," << endl
-     << "const std::string& value)" << endl
-     << ": option_ (option),"
-     << "  value_ (value)"
-     << "{"
-     << "}"
+       << inl << "bool" << endl
+       << "operator== (const string_ref& x, const string_ref& y)"
+       << "{"
+       << "return x.size () == y.size () &&" << endl
+       << "std::char_traits<char>::compare (" <<
+      "x.data (), y.data (), x.size ()) == 0;"
+       << "}"
 
-     << inl << "const std::string& invalid_value::" << endl
-     << "option () const"
-     << "{"
-     << "return option_;"
-     << "}"
+       << inl << "bool" << endl
+       << "operator!= (const string_ref& x, const string_ref& y)"
+       << "{"
+       << "return !(x == y);"
+       << "}"
 
-     << inl << "const std::string& invalid_value::" << endl
-     << "value () const"
-     << "{"
-     << "return value_;"
-     << "}";
+       << inl << "bool" << endl
+       << "operator< (const string_ref& x, const string_ref& y)"
+       << "{"
+       << "std::size_t n (x.size () < y.size () ? x.size () : y.size ());"
+       << "int r (std::char_traits<char>::compare (x.data (), y.data (), n));"
+       << "return r < 0 || (r == 0 && x.size () < y.size ());"
+       << "}";
+  }
 
-  if (ctx.options.generate_file_scanner ())
+  if (ne)
   {
-    // file_io_failure
+    // error
     //
-    os << "// file_io_failure" << endl
+    os << "// error" << endl
        << "//" << endl
 
-       << inl << "file_io_failure::" << endl
-       << "file_io_failure (const std::string& file)" << endl
-       << ": file_ (file)"
+       << inl << "error::" << endl
+       << "error (code_type code," << endl
+       << "const std::string& subject," << endl
+       << "const std::string& value)" << endl
+       << ": code_ (code), subject_ (subject), value_ (value)"
        << "{"
        << "}"
 
-       << inl << "const std::string& file_io_failure::" << endl
+       << inl << "error::code_type error::" << endl
+       << "code () const"
+       << "{"
+       << "return code_;"
+       << "}"
+
+       << inl << "const std::string& error::" << endl
+       << "option () const"
+       << "{"
+       << "return subject_;"
+       << "}"
+
+       << inl << "const std::string& error::" << endl
+       << "argument () const"
+       << "{"
+       << "return subject_;"
+       << "}"
+
+       << inl << "const std::string& error::" << endl
        << "file () const"
        << "{"
-       << "return file_;"
+       << "return subject_;"
+       << "}"
+
+       << inl << "const std::string& error::" << endl
+       << "value () const"
+       << "{"
+       << "return value_;"
+       << "}"
+
+       << inl << os_type << "&" << endl
+       << "operator<< (" << os_type << "& os, const error& e)"
+       << "{"
+       << "e.print (os);"
+       << "return os;"
+       << "}";
+
+    // scanner
+    //
+    os << "// scanner" << endl
+       << "//" << endl
+
+       << inl << "const scanner::error_type& scanner::" << endl
+       << "error () const"
+       << "{"
+       << "return error_;"
+       << "}"
+
+       << inl << "void scanner::" << endl
+       << "fail (const error_type& e)"
+       << "{"
+       << "if (error_.code () == error_type::none)" << endl
+       << "error_ = e;"
+       << "}";
+  }
+  else
+  {
+    // exception
+    //
+    os << "// exception" << endl
+       << "//" << endl
+
+       << inl << os_type << "&" << endl
+       << "operator<< (" << os_type << "& os, const exception& e)"
+       << "{"
+       << "e.print (os);"
+       << "return os;"
+       << "}";
+
+    // unknown_option
+    //
+    os << "// unknown_option" << endl
+       << "//" << endl
+
+       << inl << "unknown_option::" << endl
+       << "unknown_option (const std::string& option)" << endl
+       << ": option_ (option)"
+       << "{"
+       << "}"
+
+       << inl << "const std::string& unknown_option::" << endl
+       << "option () const"
+       << "{"
+       << "return option_;"
        << "}";
 
-    // unmatched_option
+    // unknown_argument
     //
-    os << "// unmatched_quote" << endl
+    os << "// unknown_argument" << endl
        << "//" << endl
 
-       << inl << "unmatched_quote::" << endl
-       << "unmatched_quote (const std::string& argument)" << endl
+       << inl << "unknown_argument::" << endl
+       << "unknown_argument (const std::string& argument)" << endl
        << ": argument_ (argument)"
        << "{"
        << "}"
 
-       << inl << "const std::string& unmatched_quote::" << endl
+       << inl << "const std::string& unknown_argument::" << endl
        << "argument () const"
        << "{"
        << "return argument_;"
        << "}";
+
+    // missing_value
+    //
+    os << "// missing_value" << endl
+       << "//" << endl
+
+       << inl << "missing_value::" << endl
+       << "missing_value (const std::string& option)" << endl
+       << ": option_ (option)"
+       << "{"
+       << "}"
+
+       << inl << "const std::string& missing_value::" << endl
+       << "option () const"
+       << "{"
+       << "return option_;"
+       << "}";
+
+    // invalid_value
+    //
+    os << "// invalid_value" << endl
+       << "//" << endl
+
+       << inl << "invalid_value::" << endl
+       << "invalid_value (const std::string& option," << endl
+       << "const std::string& value)" << endl
+       << ": option_ (option),"
+       << "  value_ (value)"
+       << "{"
+       << "}"
+
+       << inl << "const std::string& invalid_value::" << endl
+       << "option () const"
+       << "{"
+       << "return option_;"
+       << "}"
+
+       << inl << "const std::string& invalid_value::" << endl
+       << "value () const"
+       << "{"
+       << "return value_;"
+       << "}";
+
+    // missing_option
+    //
+    os << "// missing_option" << endl
+       << "//" << endl
+
+       << inl << "missing_option::" << endl
+       << "missing_option (const std::string& option)" << endl
+       << ": option_ (option)"
+       << "{"
+       << "}"
+
+       << inl << "const std::string& missing_option::" << endl
+       << "option () const"
+       << "{"
+       << "return option_;"
+       << "}";
+
+    // option_conflict
+    //
+    os << "// option_conflict" << endl
+       << "//" << endl
+
+       << inl << "option_conflict::" << endl
+       << "option_conflict (const std::string& option," << endl
+       << "const std::string& other)" << endl
+       << ": option_ (option),"
+       << "  other_ (other)"
+       << "{"
+       << "}"
+
+       << inl << "const std::string& option_conflict::" << endl
+       << "option () const"
+       << "{"
+       << "return option_;"
+       << "}"
+
+       << inl << "const std::string& option_conflict::" << endl
+       << "other () const"
+       << "{"
+       << "return other_;"
+       << "}";
+
+    if (ctx.options.generate_file_scanner () ||
+        ctx.options.generate_stream_scanner ())
+    {
+      // file_io_failure
+      //
+      os << "// file_io_failure" << endl
+         << "//" << endl
+
+         << inl << "file_io_failure::" << endl
+         << "file_io_failure (const std::string& file)" << endl
+         << ": file_ (file)"
+         << "{"
+         << "}"
+
+         << inl << "const std::string& file_io_failure::" << endl
+         << "file () const"
+         << "{"
+         << "return file_;"
+         << "}";
+    }
+
+    if (ctx.options.generate_file_scanner () ||
+        ctx.options.generate_string_scanner ())
+    {
+      // unmatched_quote
+      //
+      os << "// unmatched_quote" << endl
+         << "//" << endl
+
+         << inl << "unmatched_quote::" << endl
+         << "unmatched_quote (const std::string& argument)" << endl
+         << ": argument_ (argument)"
+         << "{"
+         << "}"
+
+         << inl << "const std::string& unmatched_quote::" << endl
+         << "argument () const"
+         << "{"
+         << "return argument_;"
+         << "}";
+    }
   }
 
   // argv_scanner
@@ -159,20 +370,20 @@ generate_runtime_inline (context& ctx)
 
   os << inl << "argv_scanner::" << endl
      << "argv_scanner (int& argc, char** argv, bool erase)" << endl
-     << ": i_ (1), argc_ (argc), argv_ (argv), erase_ (erase)"
+     << ": i_ (1), j_ (1), argc_ (argc), argv_ (argv), erase_ (erase)"
      << "{"
      << "}";
 
   os << inl << "argv_scanner::" << endl
      << "argv_scanner (int start, int& argc, char** argv, bool erase)" << endl
-     << ": i_ (start), argc_ (argc), argv_ (argv), erase_ (erase)"
+     << ": i_ (start), j_ (start), argc_ (argc), argv_ (argv), erase_ (erase)"
      << "{"
      << "}";
 
   os << inl << "int argv_scanner::" << endl
      << "end () const"
      << "{"
-     << "return i_;"
+     << "return j_;"
      << "}";
 
   // argv_file_scanner
@@ -180,6 +391,7 @@ generate_runtime_inline (context& ctx)
   if (ctx.options.generate_file_scanner ())
   {
     bool sep (!ctx.opt_sep.empty ());
+    bool fc (ctx.options.generate_file_cache ());
 
     os << "// argv_file_scanner" << endl
        << "//" << endl;
@@ -196,9 +408,13 @@ generate_runtime_inline (context& ctx)
     if (sep)
       os << "," << endl
          << "  skip_ (false)";
+    if (fc)
+      os << "," << endl
+         << "  cache_ (false)";
     os << "{"
        << "option_info_.option = option_.c_str ();"
        << "option_info_.search_func = 0;"
+       << "init ();"
        << "}";
 
     os << inl << "argv_file_scanner::" << endl
@@ -214,9 +430,13 @@ generate_runtime_inline (context& ctx)
     if (sep)
       os << "," << endl
          << "  skip_ (false)";
+    if (fc)
+      os << "," << endl
+         << "  cache_ (false)";
     os << "{"
        << "option_info_.option = option_.c_str ();"
        << "option_info_.search_func = 0;"
+       << "init ();"
        << "}";
 
     os << inl << "argv_file_scanner::" << endl
@@ -231,7 +451,11 @@ generate_runtime_inline (context& ctx)
     if (sep)
       os << "," << endl
          << "  skip_ (false)";
+    if (fc)
+      os << "," << endl
+         << "  cache_ (false)";
     os << "{"
+       << "init ();"
        << "}";
 
     os << inl << "argv_file_scanner::" << endl
@@ -247,7 +471,84 @@ generate_runtime_inline (context& ctx)
     if (sep)
       os << "," << endl
          << "  skip_ (false)";
+    if (fc)
+      os << "," << endl
+         << "  cache_ (false)";
     os << "{"
+       << "init ();"
+       << "}";
+
+    if (fc)
+      os << inl << "void argv_file_scanner::" << endl
+         << "cache (const std::string& dir)"
+         << "{"
+         << "cache_ = true;"
+         << "cache_dir_ = dir;"
+         << "}";
+  }
+
+  // string_scanner
+  //
+  if (ctx.options.generate_string_scanner ())
+  {
+    os << "// string_scanner" << endl
+       << "//" << endl;
+
+    os << inl << "string_scanner::" << endl
+       << "string_scanner (char* s)" << endl
+       << ": p_ (s), a_ (0)"
+       << "{"
+       << "}";
+  }
+
+  // nul_scanner and length_prefix_scanner
+  //
+  if (ctx.options.generate_buffer_scanners ())
+  {
+    os << "// nul_scanner" << endl
+       << "//" << endl;
+
+    os << inl << "nul_scanner::" << endl
+       << "nul_scanner (const char* b, std::size_t n)" << endl
+       << ": p_ (b), l_ (0), e_ (b + n)"
+       << "{"
+       << "}";
+
+    os << "// length_prefix_scanner" << endl
+       << "//" << endl;
+
+    os << inl << "length_prefix_scanner::" << endl
+       << "length_prefix_scanner (const char* b, std::size_t n)" << endl
+       << ": p_ (b), e_ (b + n), a_ (0), n_ (0)"
+       << "{"
+       << "}";
+
+    os << inl << "std::size_t length_prefix_scanner::" << endl
+       << "size () const"
+       << "{"
+       << "return n_;"
+       << "}";
+  }
+
+  // stream_scanner
+  //
+  if (ctx.options.generate_stream_scanner ())
+  {
+    os << "// stream_scanner" << endl
+       << "//" << endl;
+
+    os << inl << "stream_scanner::" << endl
+       << "stream_scanner (std::istream& is," << endl
+       << "char delimiter," << endl
+       << "std::size_t chunk_size)" << endl
+       << ": is_ (is)," << endl
+       << "  delimiter_ (delimiter)," << endl
+       << "  chunk_size_ (chunk_size != 0 ? chunk_size : 1)," << endl
+       << "  p_ (0)," << endl
+       << "  e_ (0)," << endl
+       << "  i_ (0)," << endl
+       << "  scanned_ (false)"
+       << "{"
        << "}";
   }
 
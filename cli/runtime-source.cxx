@@ -7,6 +7,34 @@
 
 using namespace std;
 
+namespace
+{
+  // Return the statement that reports an error. Unless exceptions are
+  // suppressed, this is a throw of the exception of the specified type.
+  // Otherwise, the error is recorded in the scanner s and the function
+  // returns r. If s is empty, then we are in a scanner member function
+  // where error_type has to be used since error names the accessor.
+  //
+  string
+  fail (bool ne,
+        const string& type,
+        const string& args,
+        const string& s = "",
+        const string& r = "")
+  {
+    if (!ne)
+      return "throw " + type + " (" + args + ");";
+
+    string et (s.empty () ? "error_type" : "error");
+
+    return "{" +
+      s + "fail (" + et + " (" + et + "::" + type +
+      (args.empty () ? "" : ", " + args) + "));" +
+      "return" + (r.empty () ? "" : " " + r) + ";" +
+      "}";
+  }
+}
+
 void
 generate_runtime_source (context& ctx, bool complete)
 {
@@ -19,9 +47,51 @@ generate_runtime_source (context& ctx, bool complete)
      << "#include <ostream>" << endl
      << "#include <sstream>" << endl;
 
-  if (complete && ctx.options.generate_file_scanner ())
-    os << "#include <cstring>" << endl
-       << "#include <fstream>" << endl;
+  bool fs (complete && ctx.options.generate_file_scanner ());
+  bool tab (ctx.options.option_lookup () != "map");
+  bool num (ctx.options.generate_numeric_parsers ());
+  bool bs (complete && ctx.options.generate_buffer_scanners ());
+  bool ss (complete && ctx.options.generate_stream_scanner ());
+  bool ne (ctx.options.suppress_exceptions ());
+  bool cxx11 (ctx.cxx11);
+  bool cxx17 (ctx.cxx17);
+
+  if (cxx11)
+    os << "#include <utility>" << endl;
+
+  if (cxx17 && tab)
+    os << "#include <string_view>" << endl;
+
+  if (cxx17 && ctx.options.option_lookup () == "sorted")
+    os << "#include <algorithm>" << endl;
+
+  if (num)
+    os << "#include <cfloat>" << endl
+       << "#include <climits>" << endl
+       << "#include <clocale>" << endl
+       << "#include <cstdlib>" << endl;
+
+  if (tab || num)
+    os << "#include <cstddef>" << endl;
+
+  if (fs || tab || num || bs || ss)
+    os << "#include <cstring>" << endl;
+
+  if (fs)
+    os << "#include <fstream>" << endl;
+
+  if (ss)
+    os << "#include <istream>" << endl;
+
+  if (fs && ctx.options.generate_file_cache ())
+    os << "#include <cstdio>" << endl
+       << "#include <sys/types.h>" << endl
+       << "#include <sys/stat.h>" << endl
+       << "#ifdef _WIN32" << endl
+       << "#  include <process.h> // getpid()" << endl
+       << "#else" << endl
+       << "#  include <unistd.h>  // getpid()" << endl
+       << "#endif" << endl;
 
   os << endl;
 
@@ -31,153 +101,355 @@ generate_runtime_source (context& ctx, bool complete)
   {
     string const& os_type (ctx.options.ostream_type ());
 
-    // unknown_option
+    // string_ref
     //
-    os << "// unknown_option" << endl
-       << "//" << endl
-       << "unknown_option::" << endl
-       << "~unknown_option () throw ()"
-       << "{"
-       << "}"
+    if (ctx.options.generate_string_ref ())
+      os << "// string_ref" << endl
+         << "//" << endl
+         << os_type << "&" << endl
+         << "operator<< (" << os_type << "& os, const string_ref& s)"
+         << "{"
+         << "return os << s.str ();"
+         << "}";
 
-       << "void unknown_option::" << endl
-       << "print (" << os_type << "& os) const"
-       << "{"
-       << "os << \"unknown option '\" << option ().c_str () << \"'\";"
-       << "}"
+    if (ne)
+    {
+      // error
+      //
+      os << "// error" << endl
+         << "//" << endl
+         << "void error::" << endl
+         << "print (" << os_type << "& os) const"
+         << "{"
+         << "switch (code_)"
+         << "{"
+         << "case unknown_option:" << endl
+         << "{"
+         << "os << \"unknown option '\" << option ().c_str () << \"'\";"
+         << "break;"
+         << "}"
+         << "case unknown_argument:" << endl
+         << "{"
+         << "os << \"unknown argument '\" << argument ().c_str () << \"'\";"
+         << "break;"
+         << "}"
+         << "case missing_value:" << endl
+         << "{"
+         << "os << \"missing value for option '\" << option ().c_str () << \"'\";"
+         << "break;"
+         << "}"
+         << "case invalid_value:" << endl
+         << "{"
+         << "os << \"invalid value '\" << value ().c_str () << \"' for " <<
+        "option '\"" << endl
+         << "   << option ().c_str () << \"'\";"
+         << "break;"
+         << "}"
+         << "case file_io_failure:" << endl
+         << "{"
+         << "os << \"unable to open file '\" << file ().c_str () << " <<
+        "\"' or read failure\";"
+         << "break;"
+         << "}"
+         << "case unmatched_quote:" << endl
+         << "{"
+         << "os << \"unmatched quote in argument '\" << " <<
+        "argument ().c_str () << \"'\";"
+         << "break;"
+         << "}"
+         << "case missing_option:" << endl
+         << "{"
+         << "os << \"missing required option '\" << option ().c_str () << " <<
+        "\"'\";"
+         << "break;"
+         << "}"
+         << "case option_conflict:" << endl
+         << "{"
+         << "os << \"option '\" << option ().c_str () << \"' conflicts " <<
+        "with '\"" << endl
+         << "   << value ().c_str () << \"'\";"
+         << "break;"
+         << "}"
+         << "default:" << endl
+         << "{"
+         << "os << what ();"
+         << "break;"
+         << "}"
+         << "}"
+         << "}"
 
-       << "const char* unknown_option::" << endl
-       << "what () const throw ()"
-       << "{"
-       << "return \"unknown option\";"
-       << "}";
+         << "const char* error::" << endl
+         << "what () const"
+         << "{"
+         << "switch (code_)"
+         << "{"
+         << "case none:" << endl
+         << "{"
+         << "return \"no error\";"
+         << "}"
+         << "case unknown_option:" << endl
+         << "{"
+         << "return \"unknown option\";"
+         << "}"
+         << "case unknown_argument:" << endl
+         << "{"
+         << "return \"unknown argument\";"
+         << "}"
+         << "case missing_value:" << endl
+         << "{"
+         << "return \"missing option value\";"
+         << "}"
+         << "case invalid_value:" << endl
+         << "{"
+         << "return \"invalid option value\";"
+         << "}"
+         << "case eos_reached:" << endl
+         << "{"
+         << "return \"end of argument stream reached\";"
+         << "}"
+         << "case file_io_failure:" << endl
+         << "{"
+         << "return \"unable to open file or read failure\";"
+         << "}"
+         << "case unmatched_quote:" << endl
+         << "{"
+         << "return \"unmatched quote\";"
+         << "}"
+         << "case invalid_buffer:" << endl
+         << "{"
+         << "return \"invalid argument buffer\";"
+         << "}"
+         << "case missing_option:" << endl
+         << "{"
+         << "return \"missing required option\";"
+         << "}"
+         << "case option_conflict:" << endl
+         << "{"
+         << "return \"conflicting options\";"
+         << "}"
+         << "}"
+         << "return \"\";"
+         << "}";
+    }
+    else
+    {
+      // unknown_option
+      //
+      os << "// unknown_option" << endl
+         << "//" << endl
+         << "unknown_option::" << endl
+         << "~unknown_option () throw ()"
+         << "{"
+         << "}"
 
-    // unknown_argument
-    //
-    os << "// unknown_argument" << endl
-       << "//" << endl
-       << "unknown_argument::" << endl
-       << "~unknown_argument () throw ()"
-       << "{"
-       << "}"
+         << "void unknown_option::" << endl
+         << "print (" << os_type << "& os) const"
+         << "{"
+         << "os << \"unknown option '\" << option ().c_str () << \"'\";"
+         << "}"
 
-       << "void unknown_argument::" << endl
-       << "print (" << os_type << "& os) const"
-       << "{"
-       << "os << \"unknown argument '\" << argument ().c_str () << \"'\";"
-       << "}"
+         << "const char* unknown_option::" << endl
+         << "what () const throw ()"
+         << "{"
+         << "return \"unknown option\";"
+         << "}";
 
-       << "const char* unknown_argument::" << endl
-       << "what () const throw ()"
-       << "{"
-       << "return \"unknown argument\";"
-       << "}";
+      // unknown_argument
+      //
+      os << "// unknown_argument" << endl
+         << "//" << endl
+         << "unknown_argument::" << endl
+         << "~unknown_argument () throw ()"
+         << "{"
+         << "}"
 
-    // missing_value
-    //
-    os << "// missing_value" << endl
-       << "//" << endl
-       << "missing_value::" << endl
-       << "~missing_value () throw ()"
-       << "{"
-       << "}"
+         << "void unknown_argument::" << endl
+         << "print (" << os_type << "& os) const"
+         << "{"
+         << "os << \"unknown argument '\" << argument ().c_str () << \"'\";"
+         << "}"
 
-       << "void missing_value::" << endl
-       << "print (" << os_type << "& os) const"
-       << "{"
-       << "os << \"missing value for option '\" << option ().c_str () << \"'\";"
-       << "}"
+         << "const char* unknown_argument::" << endl
+         << "what () const throw ()"
+         << "{"
+         << "return \"unknown argument\";"
+         << "}";
 
-       << "const char* missing_value::" << endl
-       << "what () const throw ()"
-       << "{"
-       << "return \"missing option value\";"
-       << "}";
+      // missing_value
+      //
+      os << "// missing_value" << endl
+         << "//" << endl
+         << "missing_value::" << endl
+         << "~missing_value () throw ()"
+         << "{"
+         << "}"
 
-    // invalid_value
-    //
-    os << "// invalid_value" << endl
-       << "//" << endl
-       << "invalid_value::" << endl
-       << "~invalid_value () throw ()"
-       << "{"
-       << "}"
+         << "void missing_value::" << endl
+         << "print (" << os_type << "& os) const"
+         << "{"
+         << "os << \"missing value for option '\" << option ().c_str () << \"'\";"
+         << "}"
 
-       << "void invalid_value::" << endl
-       << "print (" << os_type << "& os) const"
-       << "{"
-       << "os << \"invalid value '\" << value ().c_str () << \"' for " <<
-      "option '\"" << endl
-       << "   << option ().c_str () << \"'\";"
-       << "}"
+         << "const char* missing_value::" << endl
+         << "what () const throw ()"
+         << "{"
+         << "return \"missing option value\";"
+         << "}";
 
-       << "const char* invalid_value::" << endl
-       << "what () const throw ()"
-       << "{"
-       << "return \"invalid option value\";"
-       << "}";
+      // invalid_value
+      //
+      os << "// invalid_value" << endl
+         << "//" << endl
+         << "invalid_value::" << endl
+         << "~invalid_value () throw ()"
+         << "{"
+         << "}"
 
-    // eos_reached
-    //
-    os << "// eos_reached" << endl
-       << "//" << endl
-       << "void eos_reached::" << endl
-       << "print (" << os_type << "& os) const"
-       << "{"
-       << "os << what ();"
-       << "}"
+         << "void invalid_value::" << endl
+         << "print (" << os_type << "& os) const"
+         << "{"
+         << "os << \"invalid value '\" << value ().c_str () << \"' for " <<
+        "option '\"" << endl
+         << "   << option ().c_str () << \"'\";"
+         << "}"
 
-       << "const char* eos_reached::" << endl
-       << "what () const throw ()"
-       << "{"
-       << "return \"end of argument stream reached\";"
-       << "}";
+         << "const char* invalid_value::" << endl
+         << "what () const throw ()"
+         << "{"
+         << "return \"invalid option value\";"
+         << "}";
 
-    if (ctx.options.generate_file_scanner ())
-    {
-      // file_io_failure
+      // eos_reached
+      //
+      os << "// eos_reached" << endl
+         << "//" << endl
+         << "void eos_reached::" << endl
+         << "print (" << os_type << "& os) const"
+         << "{"
+         << "os << what ();"
+         << "}"
+
+         << "const char* eos_reached::" << endl
+         << "what () const throw ()"
+         << "{"
+         << "return \"end of argument stream reached\";"
+         << "}";
+
+      // missing_option
       //
-      os << "// file_io_failure" << endl
+      os << "// missing_option" << endl
          << "//" << endl
-         << "file_io_failure::" << endl
-         << "~file_io_failure () throw ()"
+         << "missing_option::" << endl
+         << "~missing_option () throw ()"
          << "{"
          << "}"
 
-         << "void file_io_failure::" << endl
+         << "void missing_option::" << endl
          << "print (" << os_type << "& os) const"
          << "{"
-         << "os << \"unable to open file '\" << file ().c_str () << " <<
-        "\"' or read failure\";"
+         << "os << \"missing required option '\" << option ().c_str () << " <<
+        "\"'\";"
          << "}"
 
-         << "const char* file_io_failure::" << endl
+         << "const char* missing_option::" << endl
          << "what () const throw ()"
          << "{"
-         << "return \"unable to open file or read failure\";"
+         << "return \"missing required option\";"
          << "}";
 
-      // unmatched_argument
+      // option_conflict
       //
-      os << "// unmatched_quote" << endl
+      os << "// option_conflict" << endl
          << "//" << endl
-         << "unmatched_quote::" << endl
-         << "~unmatched_quote () throw ()"
+         << "option_conflict::" << endl
+         << "~option_conflict () throw ()"
          << "{"
          << "}"
 
-         << "void unmatched_quote::" << endl
+         << "void option_conflict::" << endl
          << "print (" << os_type << "& os) const"
          << "{"
-         << "os << \"unmatched quote in argument '\" << " <<
-        "argument ().c_str () << \"'\";"
+         << "os << \"option '\" << option ().c_str () << \"' conflicts " <<
+        "with '\"" << endl
+         << "   << other ().c_str () << \"'\";"
          << "}"
 
-         << "const char* unmatched_quote::" << endl
+         << "const char* option_conflict::" << endl
          << "what () const throw ()"
          << "{"
-         << "return \"unmatched quote\";"
+         << "return \"conflicting options\";"
          << "}";
+
+      if (ctx.options.generate_buffer_scanners ())
+      {
+        // invalid_buffer
+        //
+        os << "// invalid_buffer" << endl
+           << "//" << endl
+           << "void invalid_buffer::" << endl
+           << "print (" << os_type << "& os) const"
+           << "{"
+           << "os << what ();"
+           << "}"
+
+           << "const char* invalid_buffer::" << endl
+           << "what () const throw ()"
+           << "{"
+           << "return \"invalid argument buffer\";"
+           << "}";
+      }
+
+      if (ctx.options.generate_file_scanner () ||
+          ctx.options.generate_stream_scanner ())
+      {
+        // file_io_failure
+        //
+        os << "// file_io_failure" << endl
+           << "//" << endl
+           << "file_io_failure::" << endl
+           << "~file_io_failure () throw ()"
+           << "{"
+           << "}"
+
+           << "void file_io_failure::" << endl
+           << "print (" << os_type << "& os) const"
+           << "{"
+           << "os << \"unable to open file '\" << file ().c_str () << " <<
+          "\"' or read failure\";"
+           << "}"
+
+           << "const char* file_io_failure::" << endl
+           << "what () const throw ()"
+           << "{"
+           << "return \"unable to open file or read failure\";"
+           << "}";
+      }
+
+      if (ctx.options.generate_file_scanner () ||
+          ctx.options.generate_string_scanner ())
+      {
+        // unmatched_quote
+        //
+        os << "// unmatched_quote" << endl
+           << "//" << endl
+           << "unmatched_quote::" << endl
+           << "~unmatched_quote () throw ()"
+           << "{"
+           << "}"
+
+           << "void unmatched_quote::" << endl
+           << "print (" << os_type << "& os) const"
+           << "{"
+           << "os << \"unmatched quote in argument '\" << " <<
+          "argument ().c_str () << \"'\";"
+           << "}"
+
+           << "const char* unmatched_quote::" << endl
+           << "what () const throw ()"
+           << "{"
+           << "return \"unmatched quote\";"
+           << "}";
+      }
     }
 
     // scanner
@@ -191,13 +463,28 @@ generate_runtime_source (context& ctx, bool complete)
 
     // argv_scanner
     //
+    // When erasing, the consumed arguments are dropped and the retained
+    // ones are moved down to j_ as we go. The unscanned tail is moved and
+    // argc is updated only once, by compact(), which makes erasing linear
+    // in the number of arguments.
+    //
     os << "// argv_scanner" << endl
        << "//" << endl
 
+       << "argv_scanner::" << endl
+       << "~argv_scanner ()"
+       << "{"
+       << "compact ();"
+       << "}"
+
        << "bool argv_scanner::" << endl
        << "more ()"
        << "{"
-       << "return i_ < argc_;"
+       << "if (i_ < argc_)" << endl
+       << "return true;"
+       << endl
+       << "compact ();"
+       << "return false;"
        << "}"
 
        << "const char* argv_scanner::" << endl
@@ -206,7 +493,7 @@ generate_runtime_source (context& ctx, bool complete)
        << "if (i_ < argc_)" << endl
        << "return argv_[i_];"
        << "else" << endl
-       << "throw eos_reached ();"
+       << fail (ne, "eos_reached", "", "", "0")
        << "}"
 
        << "const char* argv_scanner::" << endl
@@ -214,74 +501,197 @@ generate_runtime_source (context& ctx, bool complete)
        << "{"
        << "if (i_ < argc_)"
        << "{"
-       << "const char* r (argv_[i_]);"
-       << endl
-       << "if (erase_)"
-       << "{"
-       << "for (int i (i_ + 1); i < argc_; ++i)" << endl
-       << "argv_[i - 1] = argv_[i];"
+       << "const char* r (argv_[i_++]);"
        << endl
-       << "--argc_;"
-       << "argv_[argc_] = 0;"
-       << "}"
-       << "else" << endl
-       << "++i_;"
+       << "if (!erase_)" << endl
+       << "++j_;"
        << endl
        << "return r;"
        << "}"
        << "else" << endl
-       << "throw eos_reached ();"
+       << fail (ne, "eos_reached", "", "", "0")
        << "}"
 
        << "void argv_scanner::" << endl
        << "skip ()"
        << "{"
-       << "if (i_ < argc_)" << endl
+       << "if (i_ < argc_)"
+       << "{"
+       << "if (j_ != i_)" << endl
+       << "argv_[j_] = argv_[i_];"
+       << endl
        << "++i_;"
+       << "++j_;"
+       << "}"
        << "else" << endl
-       << "throw eos_reached ();"
+       << fail (ne, "eos_reached", "")
+       << "}"
+
+       << "void argv_scanner::" << endl
+       << "compact ()"
+       << "{"
+       << "if (j_ != i_)"
+       << "{"
+       << "int j (j_);"
+       << endl
+       << "for (int i (i_); i < argc_; ++i, ++j)" << endl
+       << "argv_[j] = argv_[i];"
+       << endl
+       << "argc_ = j;"
+       << "argv_[argc_] = 0;"
+       << "i_ = j_;"
+       << "}"
        << "}";
 
-    // argv_file_scanner
+    // bundle_scanner
     //
-    if (ctx.options.generate_file_scanner ())
+    // The bundle argument is consumed from the underlying scanner when the
+    // first option name is scanned so that an unknown first character
+    // leaves the argument in place. Once the value of an option has been
+    // scanned, the bundle is done and the calls are delegated.
+    //
+    if (ctx.options.bundle_short_options ())
     {
-      bool sep (!ctx.opt_sep.empty ());
-
-      os << "// argv_file_scanner" << endl
+      os << "// bundle_scanner" << endl
          << "//" << endl
 
-         << "bool argv_file_scanner::" << endl
+         << "bundle_scanner::" << endl
+         << "bundle_scanner (scanner& s)" << endl
+         << ": s_ (s), p_ (s.peek () + 1), c_ (false), v_ (false), d_ (false)"
+         << "{"
+         << "n_[0] = '-';"
+         << "n_[1] = *p_;"
+         << "n_[2] = '\\0';"
+         << "}"
+
+         << "char bundle_scanner::" << endl
+         << "option () const"
+         << "{"
+         << "return *p_;"
+         << "}"
+
+         << "bool bundle_scanner::" << endl
+         << "advance ()"
+         << "{"
+         << "if (d_ || p_[1] == '\\0')" << endl
+         << "return false;"
+         << endl
+         << "n_[1] = *++p_;"
+         << "v_ = false;"
+         << "return true;"
+         << "}"
+
+         << "bool bundle_scanner::" << endl
          << "more ()"
          << "{"
-         << "if (!args_.empty ())" << endl
+         << "if (!d_ && (!v_ || p_[1] != '\\0'))" << endl
          << "return true;"
          << endl
-         << "while (base::more ())"
+         << "return s_.more ();"
+         << "}"
+
+         << "const char* bundle_scanner::" << endl
+         << "peek ()"
          << "{"
-         << "// See if the next argument is the file option." << endl
-         << "//" << endl
-         << "const char* a (base::peek ());"
-         << "const option_info* oi;"
-         << endl
-         << "if (" << (sep ? "!skip_ && " : "") << "(oi = find (a)))"
+         << "if (!d_)"
          << "{"
-         << "base::next ();"
-         << endl
-         << "if (!base::more ())" << endl
-         << "throw missing_value (oi->option);"
+         << "if (!v_)" << endl
+         << "return n_;"
          << endl
-         << "if (oi->search_func != 0)"
+         << "if (p_[1] != '\\0')" << endl
+         << "return p_ + 1;"
+         << "}"
+         << "return s_.peek ();"
+         << "}"
+
+         << "const char* bundle_scanner::" << endl
+         << "next ()"
          << "{"
-         << "std::string f (oi->search_func (base::next (), oi->arg));"
+         << "if (!d_)"
+         << "{"
+         << "if (!v_)"
+         << "{"
+         << "if (!c_)"
+         << "{"
+         << "s_.next ();"
+         << "c_ = true;"
+         << "}"
+         << "v_ = true;"
+         << "return n_;"
+         << "}"
+         << "d_ = true;"
          << endl
-         << "if (!f.empty ())" << endl
-         << "load (f);"
+         << "if (p_[1] != '\\0')" << endl
+         << "return p_ + 1;"
+         << "}"
+         << "return s_.next ();"
+         << "}"
+
+         << "void bundle_scanner::" << endl
+         << "skip ()"
+         << "{"
+         << "next ();"
+         << "}";
+    }
+
+    // argv_file_scanner
+    //
+    if (ctx.options.generate_file_scanner ())
+    {
+      bool sep (!ctx.opt_sep.empty ());
+      bool fc (ctx.options.generate_file_cache ());
+
+      // If exceptions are suppressed, stop scanning once an error has
+      // been recorded.
+      //
+      string ok (ne ? " && error ().code () == error_type::none" : "");
+
+      os << "// argv_file_scanner" << endl
+         << "//" << endl
+
+         << "bool argv_file_scanner::" << endl
+         << "more ()"
+         << "{";
+
+      if (ne)
+        os << "if (error ().code () != error_type::none)" << endl
+           << "return false;"
+           << endl;
+
+      os << "if (!args_.empty ())" << endl
+         << "return true;"
+         << endl
+         << "while (base::more ())"
+         << "{"
+         << "// See if the next argument is the file option." << endl
+         << "//" << endl
+         << "const char* a (base::peek ());"
+         << "const option_info* oi;"
+         << endl
+         << "if (" << (sep ? "!skip_ && " : "") << "(oi = find (a)))"
+         << "{"
+         << "base::next ();"
+         << endl
+         << "if (!base::more ())" << endl
+         << fail (ne, "missing_value", "oi->option", "", "false")
+         << endl
+         << "if (oi->search_func != 0)"
+         << "{"
+         << "std::string f (oi->search_func (base::next (), oi->arg));"
+         << endl
+         << "if (!f.empty ())" << endl
+         << "load (f);"
          << "}"
          << "else" << endl
          << "load (base::next ());"
-         << endl
-         << "if (!args_.empty ())" << endl
+         << endl;
+
+      if (ne)
+        os << "if (error ().code () != error_type::none)" << endl
+           << "return false;"
+           << endl;
+
+      os << "if (!args_.empty ())" << endl
          << "return true;"
          << "}"
          << "else"
@@ -300,24 +710,24 @@ generate_runtime_source (context& ctx, bool complete)
          << "peek ()"
          << "{"
          << "if (!more ())" << endl
-         << "throw eos_reached ();"
+         << fail (ne, "eos_reached", "", "", "0")
          << endl
-         << "return args_.empty () ? base::peek () : args_.front ().c_str ();"
+         << "return args_.empty () ? base::peek () : args_.front ();"
          << "}"
 
          << "const char* argv_file_scanner::" << endl
          << "next ()"
          << "{"
          << "if (!more ())" << endl
-         << "throw eos_reached ();"
+         << fail (ne, "eos_reached", "", "", "0")
          << endl
          << "if (args_.empty ())" << endl
          << "return base::next ();"
          << "else"
          << "{"
-         << "hold_.swap (args_.front ());"
+         << "const char* r (args_.front ());"
          << "args_.pop_front ();"
-         << "return hold_.c_str ();"
+         << "return r;"
          << "}"
          << "}"
 
@@ -325,7 +735,7 @@ generate_runtime_source (context& ctx, bool complete)
          << "skip ()"
          << "{"
          << "if (!more ())" << endl
-         << "throw eos_reached ();"
+         << fail (ne, "eos_reached", "")
          << endl
          << "if (args_.empty ())" << endl
          << "return base::skip ();"
@@ -333,9 +743,55 @@ generate_runtime_source (context& ctx, bool complete)
          << "args_.pop_front ();"
          << "}"
 
+         << "void argv_file_scanner::" << endl
+         << "init ()"
+         << "{"
+         << "max_size_ = 0;"
+         << "std::memset (filter_, 0, sizeof (filter_));"
+         << endl
+         << "for (std::size_t i (0); i < options_count_; ++i)"
+         << "{"
+         << "const char* o (options_[i].option);"
+         << "std::size_t n (std::strlen (o));"
+         << endl
+         << "if (n > max_size_)" << endl
+         << "max_size_ = n;"
+         << endl
+         << "unsigned char h (hash (o, n));"
+         << "filter_[h >> 3] |= static_cast<unsigned char> (1 << (h & 7));"
+         << "}"
+         << "}"
+
+         << "unsigned char argv_file_scanner::" << endl
+         << "hash (const char* s, std::size_t n)"
+         << "{"
+         << "unsigned long h (2166136261UL);"
+         << endl
+         << "for (std::size_t i (0); i < n; ++i)" << endl
+         << "h = ((h ^ static_cast<unsigned char> (s[i])) * 16777619UL) & " <<
+        "0xFFFFFFFFUL;"
+         << endl
+         << "return static_cast<unsigned char> (" <<
+        "(h ^ (h >> 8) ^ (h >> 16) ^ (h >> 24)) & 0xFF);"
+         << "}"
+
          << "const argv_file_scanner::option_info* argv_file_scanner::" << endl
          << "find (const char* a) const"
          << "{"
+         << "// Arguments that are longer than any option name or whose" << endl
+         << "// hash is not in the filter cannot match." << endl
+         << "//" << endl
+         << "std::size_t n (0);"
+         << "for (; n <= max_size_ && a[n] != '\\0'; ++n) ;"
+         << endl
+         << "if (n > max_size_)" << endl
+         << "return 0;"
+         << endl
+         << "unsigned char h (hash (a, n));"
+         << endl
+         << "if ((filter_[h >> 3] & (1 << (h & 7))) == 0)" << endl
+         << "return 0;"
+         << endl
          << "for (std::size_t i (0); i < options_count_; ++i)" << endl
          << "if (std::strcmp (a, options_[i].option) == 0)" << endl
          << "return &options_[i];"
@@ -347,216 +803,1104 @@ generate_runtime_source (context& ctx, bool complete)
          << "load (const std::string& file)"
          << "{"
          << "using namespace std;"
-         << endl
-         << "ifstream is (file.c_str ());"
+         << endl;
+
+      if (fc)
+        os << "string key, cp;"
+           << endl
+           << "if (cache_ && cache_key (file, key))"
+           << "{"
+           << "cp = cache_file (file);"
+           << endl
+           << "if (load_cache (cp, key))" << endl
+           << "return;"
+           << "}";
+
+      os << "ifstream is (file.c_str (), ios_base::in | ios_base::binary);"
          << endl
          << "if (!is.is_open ())" << endl
-         << "throw file_io_failure (file);"
+         << fail (ne, "file_io_failure", "file")
          << endl
-         << "while (!is.eof ())"
-         << "{"
-         << "string line;"
-         << "getline (is, line);"
-         << endl
-         << "if (is.fail () && !is.eof ())" << endl
-         << "throw file_io_failure (file);"
+         << "// Read the whole file into a buffer that we keep for the" << endl
+         << "// lifetime of the scanner. The arguments are then tokenized" << endl
+         << "// in place and args_ point into this buffer. Note that" << endl
+         << "// std::deque::push_back() does not invalidate references" << endl
+         << "// to the existing elements." << endl
+         << "//" << endl
+         << "hold_.push_back (string ());"
+         << "string& b (hold_.back ());"
          << endl
-         << "string::size_type n (line.size ());"
+         << "if (!read (is, b))" << endl
+         << fail (ne, "file_io_failure", "file")
          << endl
-         << "// Trim the line from leading and trailing whitespaces." << endl
+         << "// Make sure the last line is terminated." << endl
          << "//" << endl
-         << "if (n != 0)"
+         << "b += '\\n';"
+         << endl;
+
+      if (fc)
+        os << "// Pre-tokenized content for the cache file: 'a' followed" << endl
+           << "// by the argument or 'o' followed by the option and value," << endl
+           << "// all NUL-terminated." << endl
+           << "//" << endl
+           << "string c;"
+           << endl;
+
+      os << "char* e (&b[0] + b.size ());"
+         << endl
+         << "for (char* f (&b[0]), *n; f != e" << ok << "; f = n + 1)"
          << "{"
-         << "const char* f (line.c_str ());"
-         << "const char* l (f + n);"
+         << "n = static_cast<char*> (memchr (f, '\\n', e - f));"
+         << "char* l (n);"
          << endl
-         << "const char* of (f);"
+         << "// Trim the line from leading and trailing whitespaces." << endl
+         << "//" << endl
          << "while (f < l && (*f == ' ' || *f == '\\t' || *f == '\\r'))" << endl
          << "++f;"
          << endl
+         << "while (l > f && (l[-1] == ' ' || l[-1] == '\\t' || l[-1] == '\\r'))" << endl
          << "--l;"
          << endl
-         << "const char* ol (l);"
-         << "while (l > f && (*l == ' ' || *l == '\\t' || *l == '\\r'))" << endl
-         << "--l;"
-         << endl
-         << "if (f != of || l != ol)" << endl
-         << "line = f <= l ? string (f, l - f + 1) : string ();"
-         << "}"
          << "// Ignore empty lines, those that start with #." << endl
          << "//" << endl
-         << "if (line.empty () || line[0] == '#')" << endl
+         << "if (f == l || *f == '#')" << endl
          << "continue;"
          << endl
-         << "string::size_type p (line.find (' '));"
+         << "char* p (static_cast<char*> (memchr (f, ' ', l - f)));"
          << endl
-         << "if (p == string::npos)"
-         << "{";
-      if (sep)
-        os << "if (!skip_)" << endl
-           << "skip_ = (line == \"" << ctx.opt_sep << "\");"
-           << endl;
-      os << "args_.push_back (line);"
+         << "if (p == 0)"
+         << "{"
+         << "*l = '\\0';";
+
+      if (fc)
+        os << endl
+           << "if (!key.empty ())"
+           << "{"
+           << "c += 'a';"
+           << "c += f;"
+           << "c += '\\0';"
+           << "}";
+
+      os << "process (f, 0);"
          << "}"
          << "else"
          << "{"
-         << "string s1 (line, 0, p);"
+         << "*p = '\\0';"
+         << "const char* s1 (f);"
          << endl
          << "// Skip leading whitespaces in the argument." << endl
          << "//" << endl
-         << "n = line.size ();"
-         << "for (++p; p < n; ++p)"
-         << "{"
-         << "char c (line[p]);"
-         << endl
-         << "if (c != ' ' && c != '\\t' && c != '\\r')" << endl
-         << "break;"
-         << "}"
-         << "string s2 (line, p);"
+         << "for (++p; *p == ' ' || *p == '\\t' || *p == '\\r'; ++p) ;"
          << endl
          << "// If the string is wrapped in quotes, remove them." << endl
          << "//" << endl
-         << "n = s2.size ();"
-         << "char cf (s2[0]), cl (s2[n - 1]);"
+         << "char cf (*p), cl (l[-1]);"
          << endl
          << "if (cf == '\"' || cf == '\\'' || cl == '\"' || cl == '\\'')"
          << "{"
-         << "if (n == 1 || cf != cl)" << endl
-         << "throw unmatched_quote (s2);"
+         << "if (l - p == 1 || cf != cl)" << endl
+         << fail (ne, "unmatched_quote", "string (p, l)")
+         << endl
+         << "++p;"
+         << "--l;"
+         << "}"
+         << "*l = '\\0';";
+
+      if (fc)
+        os << endl
+           << "if (!key.empty ())"
+           << "{"
+           << "c += 'o';"
+           << "c += s1;"
+           << "c += '\\0';"
+           << "c += p;"
+           << "c += '\\0';"
+           << "}";
+
+      os << "process (s1, p);"
+         << "}"
+         << "}"; // for
+
+      // Save the cache file unless the options file has changed while we
+      // were reading it. Write it under a name that is unique among the
+      // concurrent writers (the process id and the scanner address) and
+      // then rename so that a concurrently starting process does not see
+      // a partially written file. Failures are ignored.
+      //
+      if (fc)
+        os << "string k;"
+           << "if (!key.empty ()" << ok << " &&" << endl
+           << "cache_key (file, k) && k == key)"
+           << "{"
+           << "ostringstream ts;"
+           << "ts << cp << '.' << getpid () << '-'" << endl
+           << "<< static_cast<const void*> (this) << \".tmp\";"
+           << endl
+           << "string t (ts.str ());"
+           << "ofstream cs (t.c_str (), ios_base::out | ios_base::binary);"
+           << endl
+           << "if (cs.is_open ())"
+           << "{"
+           << "cs.write (key.c_str (), static_cast<streamsize> (key.size ()));"
+           << "cs.write (c.c_str (), static_cast<streamsize> (c.size ()));"
+           << "cs.put ('e');"
+           << "cs.close ();"
+           << endl
+           << "if (cs.fail () ||" << endl
+           << "(std::rename (t.c_str (), cp.c_str ()) != 0 &&" << endl
+           << "(std::remove (cp.c_str ()) != 0 ||" << endl
+           << "std::rename (t.c_str (), cp.c_str ()) != 0)))" << endl
+           << "std::remove (t.c_str ());"
+           << "}"
+           << "}";
+
+      os << "}";
+
+      // read ()
+      //
+      os << "bool argv_file_scanner::" << endl
+         << "read (std::istream& is, std::string& b)"
+         << "{"
+         << "for (std::string::size_type n (0);;)"
+         << "{"
+         << "b.resize (n == 0 ? 4096 : n * 2);"
+         << "is.read (&b[n], static_cast<std::streamsize> (b.size () - n));"
+         << "n += static_cast<std::string::size_type> (is.gcount ());"
          << endl
-         << "s2 = string (s2, 1, n - 2);"
+         << "if (!is.good ())"
+         << "{"
+         << "b.resize (n);"
+         << "return !is.bad () && is.eof ();"
+         << "}"
+         << "}"
+         << "}";
+
+      // process ()
+      //
+      // Handle an argument (v is NULL) or an option-value pair read from
+      // an options file.
+      //
+      os << "void argv_file_scanner::" << endl
+         << "process (const char* a, const char* v)"
+         << "{"
+         << "if (v == 0)"
+         << "{";
+      if (sep)
+        os << "if (!skip_)" << endl
+           << "skip_ = (std::strcmp (a, \"" << ctx.opt_sep << "\") == 0);"
+           << endl;
+      os << "args_.push_back (a);"
+         << "return;"
          << "}"
          << "const option_info* oi;"
-         << "if (" << (sep ? "!skip_ && " : "") <<
-        "(oi = find (s1.c_str ())))" << endl
+         << "if (" << (sep ? "!skip_ && " : "") << "(oi = find (a)))" << endl
          << "{"
-         << "if (s2.empty ())" << endl
-         << "throw missing_value (oi->option);"
+         << "if (*v == '\\0')" << endl
+         << fail (ne, "missing_value", "oi->option")
          << endl
          << "if (oi->search_func != 0)"
          << "{"
-         << "std::string f (oi->search_func (s2.c_str (), oi->arg));"
+         << "std::string f (oi->search_func (v, oi->arg));"
          << endl
          << "if (!f.empty ())" << endl
          << "load (f);"
          << "}"
          << "else" << endl
-         << "load (s2);"
+         << "load (v);"
          << "}"
          << "else"
          << "{"
-         << "args_.push_back (s1);"
-         << "args_.push_back (s2);"
-         << "}"
+         << "args_.push_back (a);"
+         << "args_.push_back (v);"
          << "}"
-         << "}" // while
          << "}";
+
+      if (fc)
+      {
+        // load_cache ()
+        //
+        os << "bool argv_file_scanner::" << endl
+           << "load_cache (const std::string& file, const std::string& key)"
+           << "{"
+           << "std::ifstream is (file.c_str (), " <<
+          "std::ios_base::in | std::ios_base::binary);"
+           << endl
+           << "if (!is.is_open ())" << endl
+           << "return false;"
+           << endl
+           << "std::string b;"
+           << "if (!read (is, b) ||" << endl
+           << "b.size () <= key.size () ||" << endl
+           << "b.compare (0, key.size (), key) != 0 ||" << endl
+           << "b[b.size () - 1] != 'e')" << endl
+           << "return false;"
+           << endl
+           << "// Validate the records before processing any of them." << endl
+           << "//" << endl
+           << "const char* p (b.c_str () + key.size ());"
+           << "const char* e (b.c_str () + b.size () - 1);"
+           << endl
+           << "for (const char* i (p); i != e;)"
+           << "{"
+           << "char k (*i++);"
+           << endl
+           << "for (int j (k == 'o' ? 2 : k == 'a' ? 1 : 0); j != 0; --j)"
+           << "{"
+           << "const void* z (std::memchr (i, '\\0', e - i));"
+           << endl
+           << "if (z == 0)" << endl
+           << "return false;"
+           << endl
+           << "i = static_cast<const char*> (z) + 1;"
+           << "}"
+           << "if (k != 'o' && k != 'a')" << endl
+           << "return false;"
+           << "}"
+           << "hold_.push_back (std::string ());"
+           << "hold_.back ().swap (b);"
+           << endl
+           << "p = hold_.back ().c_str () + key.size ();"
+           << "e = hold_.back ().c_str () + hold_.back ().size () - 1;"
+           << endl
+           << "while (p != e" << ok << ")"
+           << "{"
+           << "char k (*p++);"
+           << "const char* a (p);"
+           << "p += std::strlen (p) + 1;"
+           << endl
+           << "if (k == 'o')"
+           << "{"
+           << "const char* v (p);"
+           << "p += std::strlen (p) + 1;"
+           << "process (a, v);"
+           << "}"
+           << "else" << endl
+           << "process (a, 0);"
+           << "}"
+           << "return true;"
+           << "}";
+
+        // The nanoseconds part of the modification time, where available.
+        //
+        os << "static long" << endl
+           << "mtime_nsec (const struct stat& st)"
+           << "{"
+           << "#if defined(__APPLE__)" << endl
+           << "return static_cast<long> (st.st_mtimespec.tv_nsec);"
+           << "#elif defined(__linux__) || defined(__FreeBSD__) || " <<
+          "defined(__NetBSD__) || \\" << endl
+           << "defined(__OpenBSD__) || defined(__sun)" << endl
+           << "return static_cast<long> (st.st_mtim.tv_nsec);"
+           << "#else" << endl
+           << "(void) st;"
+           << "return 0;"
+           << "#endif" << endl
+           << "}";
+
+        // cache_key ()
+        //
+        // The cache file is keyed by the options file path, size,
+        // modification time (with nanoseconds where available), as well
+        // as the device and inode numbers. Only regular files are cached.
+        //
+        os << "bool argv_file_scanner::" << endl
+           << "cache_key (const std::string& file, std::string& key)"
+           << "{"
+           << "struct stat st;"
+           << endl
+           << "if (stat (file.c_str (), &st) != 0 ||" << endl
+           << "(st.st_mode & S_IFMT) != S_IFREG)" << endl
+           << "return false;"
+           << endl
+           << "std::ostringstream ks;"
+           << "ks << \"cli-options-cache 1\\n\" << file << '\\n'" << endl
+           << "<< st.st_size << ' ' << st.st_mtime << '.'" << endl
+           << "<< mtime_nsec (st) << ' '" << endl
+           << "<< st.st_dev << ' ' << st.st_ino << '\\n';"
+           << endl
+           << "key = ks.str ();"
+           << "return true;"
+           << "}";
+
+        // cache_file ()
+        //
+        os << "std::string argv_file_scanner::" << endl
+           << "cache_file (const std::string& file) const"
+           << "{"
+           << "if (cache_dir_.empty ())" << endl
+           << "return file + \".cli-cache\";"
+           << endl
+           << "unsigned long h (2166136261UL);"
+           << endl
+           << "for (std::string::size_type i (0); i != file.size (); ++i)" << endl
+           << "h = ((h ^ static_cast<unsigned char> (file[i])) * 16777619UL) & " <<
+          "0xFFFFFFFFUL;"
+           << endl
+           << "char n[16];"
+           << "for (int i (7); i >= 0; --i, h >>= 4)" << endl
+           << "n[i] = \"0123456789abcdef\"[h & 0xF];"
+           << "n[8] = '\\0';"
+           << endl
+           << "std::string r (cache_dir_);"
+           << endl
+           << "if (r[r.size () - 1] != '/')" << endl
+           << "r += '/';"
+           << endl
+           << "return r + n + \".cli-cache\";"
+           << "}";
+      }
     }
 
-    // Option description.
+    // string_scanner
     //
-    if (ctx.options.generate_description ())
+    // Arguments are scanned one at a time by more(): the argument is
+    // terminated by writing '\0' over the whitespace or closing quote
+    // that follows it.
+    //
+    if (ctx.options.generate_string_scanner ())
     {
-      // options
-      //
-      os << "void options::" << endl
-         << "push_back (const option& o)"
+      os << "// string_scanner" << endl
+         << "//" << endl
+
+         << "bool string_scanner::" << endl
+         << "more ()"
          << "{"
-         << "container_type::size_type n (size ());"
-         << "container_type::push_back (o);"
-         << "map_[o.name ()] = n;"
-         << endl
-         << "for (option_names::const_iterator i (o.aliases ().begin ());" << endl
-         << "i != o.aliases ().end (); ++i)" << endl
-         << "map_[*i] = n;"
-         << "}";
-    }
-  }
+         << "if (a_ != 0)" << endl
+         << "return true;"
+         << endl;
 
-  // To reduce the number of standard headers we have to include in the
-  // generated header file, we always generate the following templates
-  // in the source file.
-  //
-  bool sp (ctx.specifier);
+      if (ne)
+        os << "if (error ().code () != error_type::none)" << endl
+           << "return false;"
+           << endl;
 
-  // parser class template & its specializations
-  //
-  os << "template <typename X>" << endl
-     << "struct parser"
-     << "{"
-     << "static void" << endl
-     << "parse (X& x, " << (sp ? "bool& xs, " : "") << "scanner& s)"
-     << "{"
-     << "std::string o (s.next ());"
-     << endl
-     << "if (s.more ())"
-     << "{"
-     << "std::string v (s.next ());"
-     << "std::istringstream is (v);"
-     << "if (!(is >> x && is.eof ()))" << endl
-     << "throw invalid_value (o, v);"
-     << "}"
-     << "else" << endl
-     << "throw missing_value (o);";
+      os << "for (; *p_ == ' ' || *p_ == '\\t' || *p_ == '\\r' || " <<
+        "*p_ == '\\n'; ++p_) ;"
+         << endl
+         << "if (*p_ == '\\0')" << endl
+         << "return false;"
+         << endl
+         << "char* f (p_);"
+         << "char* l (f);"
+         << "char q (*f);"
+         << endl
+         << "if (q == '\"' || q == '\\'')"
+         << "{"
+         << "// The argument extends to the matching quote that is" << endl
+         << "// followed by a whitespace or the end of the string." << endl
+         << "//" << endl
+         << "for (++l; *l != '\\0'; ++l)"
+         << "{"
+         << "char c (l[1]);"
+         << endl
+         << "if (*l == q && (c == '\\0' || c == ' ' || c == '\\t' ||" << endl
+         << "c == '\\r' || c == '\\n'))" << endl
+         << "break;"
+         << "}"
+         << "if (*l == '\\0')" << endl
+         << fail (ne, "unmatched_quote", "std::string (f, l)", "", "false")
+         << endl
+         << "++f;"
+         << "}"
+         << "else"
+         << "{"
+         << "for (; *l != '\\0' && *l != ' ' && *l != '\\t' &&" << endl
+         << "*l != '\\r' && *l != '\\n'; ++l) ;"
+         << endl
+         << "if (l[-1] == '\"' || l[-1] == '\\'')" << endl
+         << fail (ne, "unmatched_quote", "std::string (f, l)", "", "false")
+         << "}"
+         << "p_ = *l != '\\0' ? l + 1 : l;"
+         << "*l = '\\0';"
+         << "a_ = f;"
+         << "return true;"
+         << "}"
 
-  if (sp)
-    os << endl
-       << "xs = true;";
+         << "const char* string_scanner::" << endl
+         << "peek ()"
+         << "{"
+         << "if (!more ())" << endl
+         << fail (ne, "eos_reached", "", "", "0")
+         << endl
+         << "return a_;"
+         << "}"
 
-  os << "}"
-     << "};";
+         << "const char* string_scanner::" << endl
+         << "next ()"
+         << "{"
+         << "if (!more ())" << endl
+         << fail (ne, "eos_reached", "", "", "0")
+         << endl
+         << "const char* r (a_);"
+         << "a_ = 0;"
+         << "return r;"
+         << "}"
 
-  // parser<bool>
-  //
-  os << "template <>" << endl
-     << "struct parser<bool>"
-     << "{"
-     << "static void" << endl
-     << "parse (bool& x, scanner& s)"
-     << "{"
-     << "s.next ();"
-     << "x = true;"
-     << "}"
-     << "};";
+         << "void string_scanner::" << endl
+         << "skip ()"
+         << "{"
+         << "if (!more ())" << endl
+         << fail (ne, "eos_reached", "")
+         << endl
+         << "a_ = 0;"
+         << "}";
+    }
 
-  // parser<string>
-  //
-  os << "template <>" << endl
-     << "struct parser<std::string>"
-     << "{"
-     << "static void" << endl
-     << "parse (std::string& x, " << (sp ? "bool& xs, " : "") << "scanner& s)"
-     << "{"
-     << "const char* o (s.next ());"
-     << endl
-     << "if (s.more ())" << endl
-     << "x = s.next ();"
-     << "else" << endl
-     << "throw missing_value (o);";
+    // nul_scanner and length_prefix_scanner
+    //
+    // The next argument is checked by more() so that a truncated argument
+    // (missing NUL or, for length_prefix_scanner, a size that goes past
+    // the end of the buffer or an embedded NUL that would silently
+    // truncate the value) is reported as invalid_buffer before it is
+    // returned.
+    //
+    if (ctx.options.generate_buffer_scanners ())
+    {
+      os << "// nul_scanner" << endl
+         << "//" << endl
 
-  if (sp)
-    os << endl
-       << "xs = true;";
+         << "bool nul_scanner::" << endl
+         << "more ()"
+         << "{"
+         << "if (l_ != 0)" << endl
+         << "return true;"
+         << endl;
 
-  os << "}"
-     << "};";
+      if (ne)
+        os << "if (error ().code () != error_type::none)" << endl
+           << "return false;"
+           << endl;
 
-  // parser<std::vector<X>>
-  //
-  os << "template <typename X>" << endl
-     << "struct parser<std::vector<X> >"
-     << "{"
-     << "static void" << endl
-     << "parse (std::vector<X>& c, " << (sp ? "bool& xs, " : "") <<
-    "scanner& s)"
-     << "{"
-     << "X x;";
+      os << "if (p_ == e_)" << endl
+         << "return false;"
+         << endl
+         << "l_ = static_cast<const char*> (" << endl
+         << "std::memchr (p_, '\\0', static_cast<std::size_t> (e_ - p_)));"
+         << endl
+         << "if (l_ == 0)" << endl
+         << fail (ne, "invalid_buffer", "", "", "false")
+         << endl
+         << "return true;"
+         << "}"
 
-  if (sp)
+         << "const char* nul_scanner::" << endl
+         << "peek ()"
+         << "{"
+         << "if (!more ())" << endl
+         << fail (ne, "eos_reached", "", "", "0")
+         << endl
+         << "return p_;"
+         << "}"
+
+         << "const char* nul_scanner::" << endl
+         << "next ()"
+         << "{"
+         << "if (!more ())" << endl
+         << fail (ne, "eos_reached", "", "", "0")
+         << endl
+         << "const char* r (p_);"
+         << "p_ = l_ + 1;"
+         << "l_ = 0;"
+         << "return r;"
+         << "}"
+
+         << "void nul_scanner::" << endl
+         << "skip ()"
+         << "{"
+         << "if (!more ())" << endl
+         << fail (ne, "eos_reached", "")
+         << endl
+         << "p_ = l_ + 1;"
+         << "l_ = 0;"
+         << "}";
+
+      os << "// length_prefix_scanner" << endl
+         << "//" << endl
+
+         << "bool length_prefix_scanner::" << endl
+         << "more ()"
+         << "{"
+         << "if (a_ != 0)" << endl
+         << "return true;"
+         << endl;
+
+      if (ne)
+        os << "if (error ().code () != error_type::none)" << endl
+           << "return false;"
+           << endl;
+
+      os << "if (p_ == e_)" << endl
+         << "return false;"
+         << endl
+         << "std::size_t n (static_cast<std::size_t> (e_ - p_));"
+         << endl
+         << "if (n < 5)" << endl
+         << fail (ne, "invalid_buffer", "", "", "false")
+         << endl
+         << "const unsigned char* u (" << endl
+         << "reinterpret_cast<const unsigned char*> (p_));"
+         << endl
+         << "n_ = static_cast<std::size_t> (u[0]) |" << endl
+         << "static_cast<std::size_t> (u[1]) << 8 |" << endl
+         << "static_cast<std::size_t> (u[2]) << 16 |" << endl
+         << "static_cast<std::size_t> (u[3]) << 24;"
+         << endl
+         << "if (n_ > n - 5 || p_[4 + n_] != '\\0' ||" << endl
+         << "std::memchr (p_ + 4, '\\0', n_) != 0)" << endl
+         << fail (ne, "invalid_buffer", "", "", "false")
+         << endl
+         << "a_ = p_ + 4;"
+         << "return true;"
+         << "}"
+
+         << "const char* length_prefix_scanner::" << endl
+         << "peek ()"
+         << "{"
+         << "if (!more ())" << endl
+         << fail (ne, "eos_reached", "", "", "0")
+         << endl
+         << "return a_;"
+         << "}"
+
+         << "const char* length_prefix_scanner::" << endl
+         << "next ()"
+         << "{"
+         << "if (!more ())" << endl
+         << fail (ne, "eos_reached", "", "", "0")
+         << endl
+         << "const char* r (a_);"
+         << "p_ = a_ + n_ + 1;"
+         << "a_ = 0;"
+         << "return r;"
+         << "}"
+
+         << "void length_prefix_scanner::" << endl
+         << "skip ()"
+         << "{"
+         << "if (!more ())" << endl
+         << fail (ne, "eos_reached", "")
+         << endl
+         << "p_ = a_ + n_ + 1;"
+         << "a_ = 0;"
+         << "}";
+    }
+
+    // stream_scanner
+    //
+    // Each argument is copied from the chunk buffer into one of the three
+    // args_ strings that are reused in turn. This way the option and its
+    // value both remain valid while the next argument is scanned and the
+    // chunk buffer can be refilled in place. In the steady state no memory
+    // is allocated.
+    //
+    if (ctx.options.generate_stream_scanner ())
+    {
+      os << "// stream_scanner" << endl
+         << "//" << endl
+
+         << "bool stream_scanner::" << endl
+         << "fill ()"
+         << "{"
+         << "if (!is_.good ())" << endl
+         << "return false;"
+         << endl
+         << "if (buf_.size () != chunk_size_)" << endl
+         << "buf_.resize (chunk_size_);"
+         << endl
+         << "is_.read (&buf_[0], static_cast<std::streamsize> (chunk_size_));"
+         << endl
+         << "if (is_.bad ())" << endl
+         << fail (ne, "file_io_failure", "\"<stream>\"", "", "false")
+         << endl
+         << "p_ = 0;"
+         << "e_ = static_cast<std::size_t> (is_.gcount ());"
+         << "return e_ != 0;"
+         << "}"
+
+         << "bool stream_scanner::" << endl
+         << "more ()"
+         << "{"
+         << "if (scanned_)" << endl
+         << "return true;"
+         << endl;
+
+      if (ne)
+        os << "if (error ().code () != error_type::none)" << endl
+           << "return false;"
+           << endl;
+
+      os << "std::string& a (args_[i_]);"
+         << "a.clear ();"
+         << endl
+         << "for (bool d (false); !d;)"
+         << "{"
+         << "if (p_ == e_ && !fill ())"
+         << "{"
+         << "// An unterminated last argument." << endl
+         << "//" << endl;
+
+      if (ne)
+        os << "if (a.empty () || error ().code () != error_type::none)" << endl
+           << "return false;"
+           << endl;
+      else
+        os << "if (a.empty ())" << endl
+           << "return false;"
+           << endl;
+
+      os << "break;"
+         << "}"
+         << "const char* b (buf_.data () + p_);"
+         << "std::size_t n (e_ - p_);"
+         << "const char* l (" << endl
+         << "static_cast<const char*> (std::memchr (b, delimiter_, n)));"
+         << endl
+         << "if (l != 0)"
+         << "{"
+         << "n = static_cast<std::size_t> (l - b);"
+         << "p_ += n + 1;"
+         << "d = true;"
+         << "}"
+         << "else" << endl
+         << "p_ = e_;"
+         << endl
+         << "a.append (b, n);"
+         << "}"
+         << "if (delimiter_ == '\\n' && !a.empty () && " <<
+        "a[a.size () - 1] == '\\r')" << endl
+         << "a.resize (a.size () - 1);"
+         << endl
+         << "scanned_ = true;"
+         << "return true;"
+         << "}"
+
+         << "const char* stream_scanner::" << endl
+         << "peek ()"
+         << "{"
+         << "if (!more ())" << endl
+         << fail (ne, "eos_reached", "", "", "0")
+         << endl
+         << "return args_[i_].c_str ();"
+         << "}"
+
+         << "const char* stream_scanner::" << endl
+         << "next ()"
+         << "{"
+         << "if (!more ())" << endl
+         << fail (ne, "eos_reached", "", "", "0")
+         << endl
+         << "const char* r (args_[i_].c_str ());"
+         << "i_ = (i_ + 1) % 3;"
+         << "scanned_ = false;"
+         << "return r;"
+         << "}"
+
+         << "void stream_scanner::" << endl
+         << "skip ()"
+         << "{"
+         << "if (!more ())" << endl
+         << fail (ne, "eos_reached", "")
+         << endl
+         << "i_ = (i_ + 1) % 3;"
+         << "scanned_ = false;"
+         << "}";
+    }
+
+    // Option description.
+    //
+    if (ctx.options.generate_description ())
+    {
+      // options
+      //
+      os << "void options::" << endl
+         << "push_back (const option& o)"
+         << "{"
+         << "container_type::size_type n (size ());"
+         << "container_type::push_back (o);"
+         << "map_[o.name ()] = n;"
+         << endl
+         << "for (option_names::const_iterator i (o.aliases ().begin ());" << endl
+         << "i != o.aliases ().end (); ++i)" << endl
+         << "map_[*i] = n;"
+         << "}";
+    }
+  }
+
+  // To reduce the number of standard headers we have to include in the
+  // generated header file, we always generate the following templates
+  // in the source file.
+  //
+  bool sp (ctx.specifier);
+
+  // parser class template & its specializations
+  //
+  os << "template <typename X>" << endl
+     << "struct parser"
+     << "{"
+     << "static void" << endl
+     << "parse (X& x, " << (sp ? "bool& xs, " : "") << "scanner& s)"
+     << "{"
+     << "const char* o (s.next ());"
+     << endl
+     << "if (s.more ())"
+     << "{"
+     << "std::string v (s.next ());"
+     << "std::istringstream is (v);"
+     << "if (!(is >> x && is.eof ()))" << endl
+     << fail (ne, "invalid_value", "o, v", "s.")
+     << "}"
+     << "else" << endl
+     << fail (ne, "missing_value", "o", "s.");
+
+  if (sp)
+    os << endl
+       << "xs = true;";
+
+  os << "}"
+     << "};";
+
+  // parser<bool>
+  //
+  os << "template <>" << endl
+     << "struct parser<bool>"
+     << "{"
+     << "static void" << endl
+     << "parse (bool& x, scanner& s)"
+     << "{"
+     << "s.next ();"
+     << "x = true;"
+     << "}"
+     << "};";
+
+  // parser<string>
+  //
+  os << "template <>" << endl
+     << "struct parser<std::string>"
+     << "{"
+     << "static void" << endl
+     << "parse (std::string& x, " << (sp ? "bool& xs, " : "") << "scanner& s)"
+     << "{"
+     << "const char* o (s.next ());"
+     << endl
+     << "if (s.more ())" << endl
+     << "x = s.next ();"
+     << "else" << endl
+     << fail (ne, "missing_value", "o", "s.");
+
+  if (sp)
+    os << endl
+       << "xs = true;";
+
+  os << "}"
+     << "};";
+
+  // parser<string_ref>
+  //
+  if (ctx.options.generate_string_ref ())
+  {
+    os << "template <>" << endl
+       << "struct parser<string_ref>"
+       << "{"
+       << "static void" << endl
+       << "parse (string_ref& x, " << (sp ? "bool& xs, " : "") <<
+      "scanner& s)"
+       << "{"
+       << "const char* o (s.next ());"
+       << endl
+       << "if (s.more ())" << endl
+       << "x = s.next ();"
+       << "else" << endl
+       << fail (ne, "missing_value", "o", "s.");
+
+    if (sp)
+      os << endl
+         << "xs = true;";
+
+    os << "}"
+       << "};";
+  }
+
+  // Conversion of a C-string to a value. Used to parse map keys and
+  // values as well as, if generated, by the numeric parsers.
+  //
+  os << "template <typename X>" << endl
+     << "struct value_parser"
+     << "{"
+     << "static bool" << endl
+     << "parse (X& x, const char* v)"
+     << "{"
+     << "std::istringstream is (v);"
+     << "return is >> x && is.eof ();"
+     << "}"
+     << "};";
+
+  os << "template <>" << endl
+     << "struct value_parser<std::string>"
+     << "{"
+     << "static bool" << endl
+     << "parse (std::string& x, const char* v)"
+     << "{"
+     << "x = v;"
+     << "return true;"
+     << "}"
+     << "};";
+
+  // Numeric parser specializations.
+  //
+  if (num)
+  {
+    // Decimal digits with overflow detection. Note that the string must
+    // not be empty.
+    //
+    os << "inline bool" << endl
+       << "parse_digits (const char* s, unsigned long max, unsigned long& r)"
+       << "{"
+       << "if (*s == '\\0')" << endl
+       << "return false;"
+       << endl
+       << "unsigned long v (0);"
+       << endl
+       << "for (; *s != '\\0'; ++s)"
+       << "{"
+       << "if (*s < '0' || *s > '9')" << endl
+       << "return false;"
+       << endl
+       << "unsigned long d (static_cast<unsigned long> (*s - '0'));"
+       << endl
+       << "if (v > (max - d) / 10)" << endl
+       << "return false;"
+       << endl
+       << "v = v * 10 + d;"
+       << "}"
+       << "r = v;"
+       << "return true;"
+       << "}";
+
+    os << "inline bool" << endl
+       << "parse_unsigned (const char* s, unsigned long max, " <<
+      "unsigned long& r)"
+       << "{"
+       << "if (*s == '+')" << endl
+       << "++s;"
+       << endl
+       << "return parse_digits (s, max, r);"
+       << "}";
+
+    os << "inline bool" << endl
+       << "parse_signed (const char* s, long min, long max, long& r)"
+       << "{"
+       << "bool n (*s == '-');"
+       << endl
+       << "if (n || *s == '+')" << endl
+       << "++s;"
+       << endl
+       << "unsigned long v;"
+       << "if (!parse_digits (s," << endl
+       << "n" << endl
+       << "? static_cast<unsigned long> (-(min + 1)) + 1" << endl
+       << ": static_cast<unsigned long> (max)," << endl
+       << "v))" << endl
+       << "return false;"
+       << endl
+       << "r = n" << endl
+       << "? (v == 0 ? 0 : -static_cast<long> (v - 1) - 1)" << endl
+       << ": static_cast<long> (v);"
+       << "return true;"
+       << "}";
+
+    // Check the syntax ourselves so that the result does not depend on
+    // the C locale (strtod() would otherwise accept things like hex,
+    // inf, and locale-specific decimal points). Then convert using the
+    // current C locale's decimal point.
+    //
+    os << "inline bool" << endl
+       << "parse_float (const char* s, double max, double& r)"
+       << "{"
+       << "const char* p (s);"
+       << "std::size_t d (0);"
+       << endl
+       << "if (*p == '-' || *p == '+')" << endl
+       << "++p;"
+       << endl
+       << "for (; *p >= '0' && *p <= '9'; ++p) ++d;"
+       << endl
+       << "const char* dot (0);"
+       << "if (*p == '.')"
+       << "{"
+       << "dot = p++;"
+       << "for (; *p >= '0' && *p <= '9'; ++p) ++d;"
+       << "}"
+       << "if (d == 0)" << endl
+       << "return false;"
+       << endl
+       << "if (*p == 'e' || *p == 'E')"
+       << "{"
+       << "++p;"
+       << endl
+       << "if (*p == '-' || *p == '+')" << endl
+       << "++p;"
+       << endl
+       << "if (*p < '0' || *p > '9')" << endl
+       << "return false;"
+       << endl
+       << "for (; *p >= '0' && *p <= '9'; ++p) ;"
+       << "}"
+       << "if (*p != '\\0')" << endl
+       << "return false;"
+       << endl
+       << "char* e;"
+       << "r = std::strtod (s, &e);"
+       << endl
+       // Only if strtod() stopped at or before our '.' do we need to
+       // consult the locale. This keeps the common case free of
+       // localeconv() whose result may be shared between threads.
+       //
+       << "if (dot != 0 && e <= dot)"
+       << "{"
+       << "const char* dp (std::localeconv ()->decimal_point);"
+       << "std::size_t n (static_cast<std::size_t> (p - s));"
+       << "std::size_t pn (static_cast<std::size_t> (dot - s));"
+       << "std::size_t dn (std::strlen (dp));"
+       << endl
+       << "char b[64];"
+       << "std::string h;"
+       << "char* t (b);"
+       << endl
+       << "if (n + dn >= sizeof (b))"
+       << "{"
+       << "h.resize (n + dn);"
+       << "t = &h[0];"
+       << "}"
+       << "std::memcpy (t, s, pn);"
+       << "std::memcpy (t + pn, dp, dn);"
+       << "std::memcpy (t + pn + dn, dot + 1, n - pn);" // Including '\0'.
+       << endl
+       << "r = std::strtod (t, 0);"
+       << "}"
+       << "return r <= max && r >= -max;"
+       << "}";
+
+    struct numeric_type
+    {
+      char const* type;
+      char const* kind;
+      char const* min;
+      char const* max;
+    };
+
+    static numeric_type const types[] =
+    {
+      {"short",          "signed",   "SHRT_MIN", "SHRT_MAX"},
+      {"unsigned short", "unsigned", 0,          "USHRT_MAX"},
+      {"int",            "signed",   "INT_MIN",  "INT_MAX"},
+      {"unsigned int",   "unsigned", 0,          "UINT_MAX"},
+      {"long",           "signed",   "LONG_MIN", "LONG_MAX"},
+      {"unsigned long",  "unsigned", 0,          "ULONG_MAX"},
+      {"float",          "float",    0,          "FLT_MAX"},
+      {"double",         "float",    0,          "DBL_MAX"},
+      {"char",           "char",     0,          0},
+      {"signed char",    "char",     0,          0},
+      {"unsigned char",  "char",     0,          0}
+    };
+
+    // We peek at the value and only consume it once it has been
+    // converted so that both the option and value strings remain valid
+    // if we need to report an error (stream_scanner reuses its storage
+    // once more arguments have been scanned).
+    //
+    for (size_t i (0); i < sizeof (types) / sizeof (numeric_type); ++i)
+    {
+      numeric_type const& t (types[i]);
+      string k (t.kind);
+
+      os << "template <>" << endl
+         << "struct value_parser<" << t.type << ">"
+         << "{"
+         << "static bool" << endl
+         << "parse (" << t.type << "& x, const char* v)"
+         << "{";
+
+      if (k == "char")
+        os << "if (v[0] == '\\0' || v[1] != '\\0')" << endl
+           << "return false;"
+           << endl
+           << "x = static_cast<" << t.type << "> (v[0]);";
+      else
+      {
+        if (k == "signed")
+          os << "long r;"
+             << "if (!parse_signed (v, " << t.min << ", " << t.max << ", r))";
+        else if (k == "unsigned")
+          os << "unsigned long r;"
+             << "if (!parse_unsigned (v, " << t.max << ", r))";
+        else
+          os << "double r;"
+             << "if (!parse_float (v, " << t.max << ", r))";
+
+        os << endl
+           << "return false;"
+           << endl
+           << "x = static_cast<" << t.type << "> (r);";
+      }
+
+      os << "return true;"
+         << "}"
+         << "};";
+
+      os << "template <>" << endl
+         << "struct parser<" << t.type << ">"
+         << "{"
+         << "static void" << endl
+         << "parse (" << t.type << "& x, " << (sp ? "bool& xs, " : "") <<
+        "scanner& s)"
+         << "{"
+         << "const char* o (s.next ());"
+         << endl
+         << "if (s.more ())"
+         << "{"
+         << "const char* v (s.peek ());"
+         << endl
+         << "if (!value_parser<" << t.type << ">::parse (x, v))" << endl
+         << fail (ne, "invalid_value", "o, v", "s.")
+         << endl;
+
+      os << "s.next ();"
+         << "}"
+         << "else" << endl
+         << fail (ne, "missing_value", "o", "s.");
+
+      if (sp)
+        os << endl
+           << "xs = true;";
+
+      os << "}"
+         << "};";
+    }
+  }
+
+  // parser<std::vector<X>>
+  //
+  os << "template <typename X>" << endl
+     << "struct parser<std::vector<X> >"
+     << "{"
+     << "static void" << endl
+     << "parse (std::vector<X>& c, " << (sp ? "bool& xs, " : "") <<
+    "scanner& s)"
+     << "{"
+     << "X x;";
+
+  if (sp)
     os << "bool dummy;";
 
-  os << "parser<X>::parse (x, " << (sp ? "dummy, " : "") << "s);"
-     << "c.push_back (x);";
+  os << "parser<X>::parse (x, " << (sp ? "dummy, " : "") << "s);";
+
+  if (ne)
+    os << endl
+       << "if (s.error ().code () != error::none)" << endl
+       << "return;"
+       << endl;
+
+  os << (cxx11 ? "c.push_back (std::move (x));" : "c.push_back (x);");
 
   if (sp)
     os << "xs = true;";
@@ -564,6 +1908,40 @@ generate_runtime_source (context& ctx, bool complete)
   os << "}"
      << "};";
 
+  // parser<sink<X>>
+  //
+  // The value is parsed into a temporary which is then passed to the
+  // sink function instead of being stored.
+  //
+  os << "template <typename X>" << endl
+     << "struct parser<sink<X> >"
+     << "{"
+     << "static void" << endl
+     << "parse (sink<X>& c, " << (sp ? "bool& xs, " : "") << "scanner& s)"
+     << "{"
+     << "X x;";
+
+  if (sp)
+    os << "bool dummy;";
+
+  os << "parser<X>::parse (x, " << (sp ? "dummy, " : "") << "s);";
+
+  if (ne)
+    os << endl
+       << "if (s.error ().code () != error::none)" << endl
+       << "return;"
+       << endl;
+
+  os << "if (c.func != 0)" << endl
+     << "c.func (x, c.arg);";
+
+  if (sp)
+    os << endl
+       << "xs = true;";
+
+  os << "}"
+     << "};";
+
   // parser<std::set<X>>
   //
   os << "template <typename X>" << endl
@@ -577,8 +1955,15 @@ generate_runtime_source (context& ctx, bool complete)
   if (sp)
     os << "bool dummy;";
 
-  os << "parser<X>::parse (x, " << (sp ? "dummy, " : "") << "s);"
-     << "c.insert (x);";
+  os << "parser<X>::parse (x, " << (sp ? "dummy, " : "") << "s);";
+
+  if (ne)
+    os << endl
+       << "if (s.error ().code () != error::none)" << endl
+       << "return;"
+       << endl;
+
+  os << (cxx11 ? "c.insert (std::move (x));" : "c.insert (x);");
 
   if (sp)
     os << "xs = true;";
@@ -595,52 +1980,36 @@ generate_runtime_source (context& ctx, bool complete)
      << "parse (std::map<K, V>& m, " << (sp ? "bool& xs, " : "") <<
     "scanner& s)"
      << "{"
-     << "std::string o (s.next ());"
+     << "const char* o (s.next ());"
      << endl
      << "if (s.more ())"
      << "{"
+     << "// Split key=value in place by replacing '=' with '\\0'." << endl
+     << "//" << endl
      << "std::string ov (s.next ());"
-     << "std::string::size_type p = ov.find ('=');"
+     << "std::string::size_type p (ov.find ('='));"
      << endl
-     << "if (p == std::string::npos)"
-     << "{"
-     << "K k = K ();"
+     << "if (p != std::string::npos)" << endl
+     << "ov[p] = '\\0';"
      << endl
-     << "if (!ov.empty ())"
-     << "{"
-     << "std::istringstream ks (ov);"
+     << "const char* kv (ov.c_str ());"
+     << "const char* vv (p != std::string::npos ? kv + p + 1 : \"\");"
      << endl
-     << "if (!(ks >> k && ks.eof ()))" << endl
-     << "throw invalid_value (o, ov);"
-     << "}"
-     << "m[k] = V ();"
-     << "}"
-     << "else"
-     << "{"
      << "K k = K ();"
      << "V v = V ();"
-     << "std::string kstr (ov, 0, p);"
-     << "std::string vstr (ov, p + 1);"
      << endl
-     << "if (!kstr.empty ())"
+     << "if ((*kv != '\\0' && !value_parser<K>::parse (k, kv)) ||" << endl
+     << "(*vv != '\\0' && !value_parser<V>::parse (v, vv)))"
      << "{"
-     << "std::istringstream ks (kstr);"
+     << "if (p != std::string::npos)" << endl
+     << "ov[p] = '=';"
      << endl
-     << "if (!(ks >> k && ks.eof ()))" << endl
-     << "throw invalid_value (o, ov);"
-     << "}"
-     << "if (!vstr.empty ())"
-     << "{"
-     << "std::istringstream vs (vstr);"
-     << endl
-     << "if (!(vs >> v && vs.eof ()))" << endl
-     << "throw invalid_value (o, ov);"
-     << "}"
-     << "m[k] = v;"
+     << fail (ne, "invalid_value", "o, ov", "s.")
      << "}"
+     << (cxx11 ? "m[std::move (k)] = std::move (v);" : "m[k] = v;")
      << "}"
      << "else" << endl
-     << "throw missing_value (o);";
+     << fail (ne, "missing_value", "o", "s.");
 
   if (sp)
     os << endl
@@ -666,5 +2035,341 @@ generate_runtime_source (context& ctx, bool complete)
        << "parser<T>::parse (x.*M, x.*S, s);"
        << "}";
 
+  // Parser thunks for the packed bool options and specifier flags. The
+  // flag bit I is stored in the flag set F.
+  //
+  if (ctx.pack)
+  {
+    os << "template <typename X, typename F, F X::*B, std::size_t I>" << endl
+       << "void" << endl
+       << "flag_thunk (X& x, scanner& s)"
+       << "{"
+       << "bool v (false);"
+       << "parser<bool>::parse (v, s);"
+       << "if (v)" << endl
+       << "(x.*B).set (I);"
+       << "}";
+
+    if (ctx.specifier)
+      os << "template <typename X, typename T, T X::*M, " <<
+        "typename F, F X::*B, std::size_t I>" << endl
+         << "void" << endl
+         << "specifier_thunk (X& x, scanner& s)"
+         << "{"
+         << "bool xs (false);"
+         << "parser<T>::parse (x.*M, xs, s);"
+         << "if (xs)" << endl
+         << "(x.*B).set (I);"
+         << "}";
+  }
+
+  // Parser thunk adapter that also sets the presence bit I in the mask
+  // P of the options referenced in constraints.
+  //
+  os << "template <typename X, typename F, F X::*P, std::size_t I, " <<
+    "void (*T) (X&, scanner&)>" << endl
+     << "void" << endl
+     << "presence_thunk (X& x, scanner& s)"
+     << "{"
+     << "(*T) (x, s);"
+     << "(x.*P).set (I);"
+     << "}";
+
+  // Parser thunk adapter for lazy options that cancels the default value
+  // computation if the option is specified.
+  //
+  os << "template <typename X, bool X::*L, void (*T) (X&, scanner&)>" << endl
+     << "void" << endl
+     << "lazy_thunk (X& x, scanner& s)"
+     << "{"
+     << "x.*L = false;"
+     << "(*T) (x, s);"
+     << "}";
+
+  // Table-driven parsing. The values of the common types are parsed
+  // by parse_option() itself while the rest go through parse_value()
+  // which is instantiated once per type rather than once per option.
+  //
+  if (ctx.tabular)
+  {
+    os << "template <typename T>" << endl
+       << "void" << endl
+       << "parse_value (void* x, bool&" << (sp ? " xs" : "") << ", " <<
+      "scanner& s)"
+       << "{"
+       << "parser<T>::parse (*static_cast<T*> (x), " << (sp ? "xs, " : "") <<
+      "s);"
+       << "}";
+
+    if (complete)
+    {
+      string xs (sp ? "xs, " : "");
+
+      os << "void" << endl
+         << "parse_option (const option_desc& d, " <<
+        "const option_ref& r, scanner& s)"
+         << "{"
+         << "if (r.lazy != 0)" << endl
+         << "*r.lazy = false;"
+         << endl
+         << "bool xs (false);"
+         << endl
+         << "switch (d.type)"
+         << "{"
+         << "case option_desc::bool_value:" << endl
+         << "{"
+         << "parser<bool>::parse (xs, s);"
+         << endl
+         << "if (r.value != 0)" << endl
+         << "*static_cast<bool*> (r.value) = xs;"
+         << "break;"
+         << "}"
+         << "case option_desc::string_value:" << endl
+         << "{"
+         << "parser<std::string>::parse (" << endl
+         << "*static_cast<std::string*> (r.value), " << xs << "s);"
+         << "break;"
+         << "}"
+         << "case option_desc::int_value:" << endl
+         << "{"
+         << "parser<int>::parse (*static_cast<int*> (r.value), " << xs <<
+        "s);"
+         << "break;"
+         << "}"
+         << "case option_desc::unsigned_int_value:" << endl
+         << "{"
+         << "parser<unsigned int>::parse (" << endl
+         << "*static_cast<unsigned int*> (r.value), " << xs << "s);"
+         << "break;"
+         << "}"
+         << "case option_desc::long_value:" << endl
+         << "{"
+         << "parser<long>::parse (*static_cast<long*> (r.value), " << xs <<
+        "s);"
+         << "break;"
+         << "}"
+         << "case option_desc::unsigned_long_value:" << endl
+         << "{"
+         << "parser<unsigned long>::parse (" << endl
+         << "*static_cast<unsigned long*> (r.value), " << xs << "s);"
+         << "break;"
+         << "}"
+         << "case option_desc::double_value:" << endl
+         << "{"
+         << "parser<double>::parse (*static_cast<double*> (r.value), " <<
+        xs << "s);"
+         << "break;"
+         << "}"
+         << "case option_desc::string_vector_value:" << endl
+         << "{"
+         << "parser<std::vector<std::string> >::parse (" << endl
+         << "*static_cast<std::vector<std::string>*> (r.value), " << xs <<
+        "s);"
+         << "break;"
+         << "}"
+         << "default:" << endl
+         << "{"
+         << "(*r.parse) (r.value, xs, s);"
+         << "break;"
+         << "}"
+         << "}";
+
+      // The packed flag is either the bool option value or the
+      // specifier.
+      //
+      os << "if (xs)"
+         << "{"
+         << "if (r.specifier != 0)" << endl
+         << "*r.specifier = true;"
+         << endl
+         << "if (r.flags != 0)" << endl
+         << "r.flags[d.flag / 8] |= " <<
+        "static_cast<unsigned char> (1U << (d.flag % 8));"
+         << "}"
+         << "if (r.presence != 0)" << endl
+         << "r.presence[d.presence / 8] |= " <<
+        "static_cast<unsigned char> (1U << (d.presence % 8));"
+         << "}";
+    }
+  }
+
+  // Option value reset that retains the allocated memory where possible.
+  //
+  if (ctx.options.generate_parse ())
+    os << "template <typename X>" << endl
+       << "inline void" << endl
+       << "reset_value (X& x)"
+       << "{"
+       << "x = X ();"
+       << "}"
+       << "inline void" << endl
+       << "reset_value (std::string& x)"
+       << "{"
+       << "x.clear ();"
+       << "}"
+       << "template <typename X>" << endl
+       << "inline void" << endl
+       << "reset_value (std::vector<X>& x)"
+       << "{"
+       << "x.clear ();"
+       << "}";
+
+  // Adapter for parsing options of the base class B in the options
+  // lookup table of the derived class X.
+  //
+  os << "template <typename X, typename B, void (*F) (B&, scanner&)>" << endl
+     << "void" << endl
+     << "base_thunk (X& x, scanner& s)"
+     << "{"
+     << "(*F) (x, s);"
+     << "}";
+
+  // Constant-initialized option tables support.
+  //
+  string const& lookup (ctx.options.option_lookup ());
+
+  if (tab && !ctx.tabular)
+    os << "template <typename X>" << endl
+       << "struct option_entry"
+       << "{"
+       << "const char* name;"
+       << "std::size_t size;"
+       << "void (*thunk) (X&, scanner&);"
+       << "};";
+
+  // With C++17 the tables are constexpr and the option names are
+  // compared as std::string_view which allows checking the tables at
+  // compile time.
+  //
+  if (cxx17 && tab)
+    os << "template <typename E>" << endl
+       << "constexpr std::string_view" << endl
+       << "option_name (const E& e)"
+       << "{"
+       << "return std::string_view (e.name, e.size);"
+       << "}";
+
+  // Binary search in a table sorted in the std::strcmp() order. The
+  // table entry is option_entry or, with the table backend, option_desc.
+  //
+  if (lookup == "sorted")
+  {
+    if (cxx17)
+    {
+      os << "template <typename E>" << endl
+         << "constexpr bool" << endl
+         << "option_less (const E& e, std::string_view v)"
+         << "{"
+         << "return option_name (e) < v;"
+         << "}";
+
+      os << "template <typename E>" << endl
+         << "const E*" << endl
+         << "option_search (const E* t, std::size_t n, const char* o)"
+         << "{"
+         << "std::string_view v (o);"
+         << "const E* i (std::lower_bound (t, t + n, v, &option_less<E>));"
+         << "return i != t + n && option_name (*i) == v ? i : nullptr;"
+         << "}";
+
+      // The names are unique if they are strictly increasing.
+      //
+      os << "template <typename E>" << endl
+         << "constexpr bool" << endl
+         << "option_sorted (const E* t, std::size_t n)"
+         << "{"
+         << "for (std::size_t i (1); i < n; ++i)"
+         << "{"
+         << "if (!(option_name (t[i - 1]) < option_name (t[i])))" << endl
+         << "return false;"
+         << "}"
+         << "return true;"
+         << "}";
+    }
+    else
+      os << "template <typename E>" << endl
+         << "const E*" << endl
+         << "option_search (const E* t, std::size_t n, const char* o)"
+         << "{"
+         << "std::size_t b (0), e (n);"
+         << endl
+         << "while (b < e)"
+         << "{"
+         << "std::size_t m (b + (e - b) / 2);"
+         << "int r (std::strcmp (o, t[m].name));"
+         << endl
+         << "if (r == 0)" << endl
+         << "return t + m;"
+         << endl
+         << "if (r < 0)" << endl
+         << "e = m;"
+         << "else" << endl
+         << "b = m + 1;"
+         << "}"
+         << "return 0;"
+         << "}";
+  }
+
+  // Perfect hash lookup support. The hash function must match the one
+  // used by the CLI compiler to construct the tables (see source.cxx).
+  //
+  if (lookup == "hash")
+  {
+    os << (cxx17 ? "constexpr" : "inline") << " void" << endl
+       << "option_hash (const char* s," << endl
+       << "std::size_t& n," << endl
+       << "unsigned long& f," << endl
+       << "unsigned long& g)"
+       << "{"
+       << "const char* p (s);"
+       << endl
+       << "for (; *p != '\\0'; ++p)"
+       << "{"
+       << "unsigned long c (static_cast<unsigned char> (*p));"
+       << "f = ((f ^ c) * 16777619UL) & 0xFFFFFFFFUL;"
+       << "g = ((g ^ c) * 16777619UL) & 0xFFFFFFFFUL;"
+       << "}"
+       << "f ^= f >> 16;"
+       << "f = (f * 0x7FEB352DUL) & 0xFFFFFFFFUL;"
+       << "f ^= f >> 15;"
+       << endl
+       << "g ^= g >> 16;"
+       << "g = (g * 0x7FEB352DUL) & 0xFFFFFFFFUL;"
+       << "g ^= g >> 15;"
+       << endl
+       << "n = static_cast<std::size_t> (p - s);"
+       << "}";
+
+    // Each name must hash to its own slot (empty slots have null names)
+    // which, since there is only one slot per hash value, also means
+    // that the names are unique. The check is linear in the total size
+    // of the names.
+    //
+    if (cxx17)
+      os << "template <typename E>" << endl
+         << "constexpr bool" << endl
+         << "option_unique (const E* t," << endl
+         << "std::size_t n," << endl
+         << "unsigned long fs," << endl
+         << "unsigned long gs," << endl
+         << "const unsigned long* d)"
+         << "{"
+         << "for (std::size_t i (0); i < n; ++i)"
+         << "{"
+         << "if (t[i].name == nullptr)" << endl
+         << "continue;"
+         << endl
+         << "std::size_t m (0);"
+         << "unsigned long f (fs), g (gs);"
+         << "option_hash (t[i].name, m, f, g);"
+         << endl
+         << "if (m != t[i].size ||" << endl
+         << "((f + d[g & (n - 1)]) & (n - 1)) != i)" << endl
+         << "return false;"
+         << "}"
+         << "return true;"
+         << "}";
+  }
+
   ctx.cli_close ();
 }
@@ -13,6 +13,21 @@
 namespace semantics
 {
   class class_;
+  class option;
+
+  // Constraint on the presence of the class options that is checked
+  // after parsing. If dependent is not NULL, then the constraint only
+  // applies if that option was specified.
+  //
+  struct constraint
+  {
+    constraint (): required (false), exclusive (false), dependent (0) {}
+
+    bool required;  // At least one of the options must be specified.
+    bool exclusive; // At most one of the options can be specified.
+    option* dependent;
+    std::vector<option*> options;
+  };
 
   class inherits: public edge
   {
@@ -80,6 +95,21 @@ namespace semantics
       return inherits_.end ();
     }
 
+  public:
+    typedef std::vector<constraint> constraint_list;
+
+    constraint_list&
+    constraints ()
+    {
+      return constraints_;
+    }
+
+    constraint_list const&
+    constraints () const
+    {
+      return constraints_;
+    }
+
   public:
     class_ (path const& file, size_t line, size_t column)
         : node (file, line, column), abstract_ (false)
@@ -101,6 +131,7 @@ namespace semantics
   private:
     bool abstract_;
     inherits_list inherits_;
+    constraint_list constraints_;
   };
 }
 
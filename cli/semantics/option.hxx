@@ -137,6 +137,37 @@ namespace semantics
       return initialized_->expression ();
     }
 
+  public:
+    // A sink option passes each value to a user-supplied function
+    // instead of storing it.
+    //
+    bool
+    sink () const
+    {
+      return sink_;
+    }
+
+    void
+    sink (bool s)
+    {
+      sink_ = s;
+    }
+
+    // The default value of a lazy option is computed on the first read
+    // unless the option was specified.
+    //
+    bool
+    lazy () const
+    {
+      return lazy_;
+    }
+
+    void
+    lazy (bool l)
+    {
+      lazy_ = l;
+    }
+
   public:
     typedef std::vector<string> doc_list;
     typedef doc_list::const_iterator doc_iterator;
@@ -167,7 +198,10 @@ namespace semantics
 
   public:
     option (path const& file, size_t line, size_t column)
-        : node (file, line, column), initialized_ (0)
+        : node (file, line, column),
+          initialized_ (0),
+          sink_ (false),
+          lazy_ (false)
     {
     }
 
@@ -186,6 +220,8 @@ namespace semantics
   private:
     belongs_type* belongs_;
     initialized_type* initialized_;
+    bool sink_;
+    bool lazy_;
     doc_list doc_;
   };
 }
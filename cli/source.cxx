@@ -3,11 +3,19 @@
 // copyright : Copyright (c) 2009-2011 Code Synthesis Tools CC
 // license   : MIT; see accompanying LICENSE file
 
+#include <cctype>    // std::isxdigit, std::isdigit, std::tolower
+#include <map>
+#include <set>
+#include <vector>
+#include <utility>   // std::pair
+#include <sstream>
 #include <iostream>
+#include <algorithm> // std::sort
 
 #include "source.hxx"
 
 using std::cerr;
+using std::string;
 
 namespace
 {
@@ -20,6 +28,14 @@ namespace
     virtual void
     traverse (type& o)
     {
+      bool p (packed (o));
+
+      // The packed bool option values are initialized in the c-tor body
+      // (see option_flag_init below).
+      //
+      if (p && o.type ().name () == "bool")
+        return;
+
       if (comma_)
         os << "," << endl
            << "  ";
@@ -32,7 +48,12 @@ namespace
 
       os << emember (o);
 
-      if (o.initialized_p ())
+      // The default value of a lazy option is assigned by the accessor.
+      //
+      if (o.lazy ())
+        os << " ()," << endl
+           << "  " << elazy_member (o) << " (true)";
+      else if (o.initialized_p ())
       {
         using semantics::expression;
         expression const& i (o.initializer ());
@@ -59,7 +80,7 @@ namespace
       else
         os << " ()";
 
-      if (specifier && o.type ().name () != "bool")
+      if (specifier && o.type ().name () != "bool" && !p)
         os << "," << endl
            << "  " << especifier_member (o) << " (false)";
     }
@@ -68,11 +89,80 @@ namespace
     bool comma_;
   };
 
+  // Set the bits of the packed bool options that have initializers. All
+  // the other bits are cleared by the flag_set c-tor and reset().
   //
+  struct option_flag_init: traversal::option, context
+  {
+    option_flag_init (context& c) : context (c) {}
+
+    virtual void
+    traverse (type& o)
+    {
+      if (!packed (o) || o.type ().name () != "bool" || !o.initialized_p ())
+        return;
+
+      using semantics::expression;
+      expression const& i (o.initializer ());
+
+      os << eflags_member (o.scope ()) << ".set (" << flag_bit (o) << ", ";
+
+      switch (i.type ())
+      {
+      case expression::string_lit:
+      case expression::char_lit:
+      case expression::bool_lit:
+      case expression::int_lit:
+      case expression::float_lit:
+      case expression::identifier:
+        {
+          os << i.value ();
+          break;
+        }
+      case expression::call_expr:
+        {
+          os << "bool " << i.value ();
+          break;
+        }
+      }
+
+      os << ");";
+    }
+  };
+
+  // Collect option names together with their parsing thunks. The
+  // options of a base class are parsed with a base_thunk adapter for
+  // each inheritance edge on the path from the derived class to the
+  // base. Converting one edge at a time keeps the conversion unambiguous
+  // if the base is reachable through several paths (non-virtual diamond).
   //
-  struct option_map: traversal::option, context
+  struct option_entry
+  {
+    string name;
+    string thunk;
+
+    // Option and the expression prefix for accessing its members in the
+    // derived class (used by the table backend).
+    //
+    semantics::option* option;
+    string object;
+  };
+
+  typedef std::vector<option_entry> option_entries;
+
+  struct option_entries_collector: traversal::option, context
   {
-    option_map (context& c) : context (c) {}
+    typedef std::vector<semantics::class_*> path_type;
+
+    // The path starts with the derived class and ends with the class
+    // whose options are being collected.
+    //
+    option_entries_collector (context& c,
+                              option_entries& e,
+                              path_type const& p)
+        : context (c), entries_ (e), path_ (p)
+    {
+    }
 
     virtual void
     traverse (type& o)
@@ -80,24 +170,454 @@ namespace
       using semantics::names;
 
       string member (emember (o));
-      string type (o.type ().name ());
-      string scope (escape (o.scope ().name ()));
-      string map ("_cli_" + scope + "_map_");
+      string type (member_type (o));
+
+      semantics::scope& s (o.scope ());
+      bool base (path_.size () > 1);
+      string scope (base ? fq_name (s) : escape (s.name ()));
+
+      string t;
+
+      if (packed (o))
+      {
+        std::ostringstream f;
+        f << cli << "::flag_set< " << flag_count (s) << " >, " <<
+          "&" << scope << "::" << eflags_member (s) << ", " <<
+          flag_bit (o) << " >";
+
+        if (type == "bool")
+          t = "&" + cli + "::flag_thunk< " + scope + ", " + f.str ();
+        else
+          t = "&" + cli + "::specifier_thunk< " + scope + ", " + type +
+            ", &" + scope + "::" + member + ", " + f.str ();
+      }
+      else
+      {
+        t = "&" + cli + "::thunk< " + scope + ", " + type + ", " +
+          "&" + scope + "::" + member;
+
+        if (specifier && type != "bool")
+          t += ", &" + scope + "::" + especifier_member (o);
+
+        t += " >";
+      }
+
+      // Specifying a lazy option cancels the default value computation.
+      //
+      if (o.lazy ())
+        t = "&" + cli + "::lazy_thunk< " + scope + ", &" + scope + "::" +
+          elazy_member (o) + ", " + t + " >";
+
+      // Options referenced in constraints also set their presence bit.
+      //
+      if (presence_p (o))
+      {
+        std::ostringstream p;
+        p << "&" << cli << "::presence_thunk< " << scope << ", " <<
+          cli << "::flag_set< " << presence_count (s) << " >, " <<
+          "&" << scope << "::" << epresence_member (s) << ", " <<
+          presence_bit (o) << ", " << t << " >";
+        t = p.str ();
+      }
+
+      // Wrap the thunk from the class that declares the option up to
+      // the derived class and build the matching conversion expression.
+      //
+      string object ("*this");
+
+      for (size_t i (path_.size () - 1); i != 0; --i)
+        t = "&" + cli + "::base_thunk< " + class_name (i - 1) + ", " +
+          class_name (i) + ", " + t + " >";
+
+      for (size_t i (1); i < path_.size (); ++i)
+        object = "static_cast< " + class_name (i) + "& > (" + object + ")";
 
       names& n (o.named ());
 
       for (names::name_iterator i (n.name_begin ()); i != n.name_end (); ++i)
       {
-        os << "_cli_" << scope << "_map_[\"" << *i << "\"] = " << endl
-           << "&" << cli << "::thunk< " << scope << ", " << type << ", " <<
-          "&" << scope << "::" << member;
+        option_entry e;
+        e.name = *i;
+        e.thunk = t;
+        e.option = &o;
+        e.object = base ? object + "." : "this->";
+        entries_.push_back (e);
+      }
+    }
 
-        if (specifier && type != "bool")
-          os << "," << endl
-             << "  &" << scope << "::" << especifier_member (o);
+  private:
+    string
+    class_name (size_t i)
+    {
+      return i == 0 ? escape (path_[0]->name ()) : fq_name (*path_[i]);
+    }
+
+  private:
+    option_entries& entries_;
+    path_type const& path_;
+  };
+
+  // Perfect hash table construction. The hash function must match the
+  // option_hash() function in the generated runtime (see
+  // runtime-source.cxx).
+  //
+  unsigned long
+  mix (unsigned long h)
+  {
+    h ^= h >> 16;
+    h = (h * 0x7FEB352DUL) & 0xFFFFFFFFUL;
+    h ^= h >> 15;
+    return h;
+  }
+
+  // Return the string value of the option name as it would be seen by
+  // the C++ compiler (option names that come from string literals can
+  // contain escape sequences).
+  //
+  string
+  unescape (string const& s)
+  {
+    string r;
+
+    for (size_t i (0), n (s.size ()); i < n; ++i)
+    {
+      char c (s[i]);
+
+      if (c != '\\' || i + 1 == n)
+      {
+        r += c;
+        continue;
+      }
+
+      c = s[++i];
+
+      switch (c)
+      {
+      case 'a':
+        {
+          r += '\a';
+          break;
+        }
+      case 'b':
+        {
+          r += '\b';
+          break;
+        }
+      case 'f':
+        {
+          r += '\f';
+          break;
+        }
+      case 'n':
+        {
+          r += '\n';
+          break;
+        }
+      case 'r':
+        {
+          r += '\r';
+          break;
+        }
+      case 't':
+        {
+          r += '\t';
+          break;
+        }
+      case 'v':
+        {
+          r += '\v';
+          break;
+        }
+      case 'x':
+        {
+          unsigned int v (0);
+
+          for (; i + 1 < n && isxdigit (static_cast<unsigned char> (s[i + 1]));
+               ++i)
+          {
+            unsigned char d (static_cast<unsigned char> (s[i + 1]));
+            v = v * 16 + (isdigit (d) ? d - '0' : tolower (d) - 'a' + 10);
+          }
+
+          r += static_cast<char> (v);
+          break;
+        }
+      default:
+        {
+          if (c >= '0' && c <= '7')
+          {
+            unsigned int v (c - '0');
+
+            for (size_t j (0);
+                 j < 2 && i + 1 < n && s[i + 1] >= '0' && s[i + 1] <= '7';
+                 ++j, ++i)
+              v = v * 8 + (s[i + 1] - '0');
+
+            r += static_cast<char> (v);
+          }
+          else
+            r += c; // \\, \", \', and \?.
+
+          break;
+        }
+      }
+    }
+
+    return r;
+  }
+
+  struct perfect_hash
+  {
+    unsigned long f_seed;
+    unsigned long g_seed;
+
+    // Both the table and displacement array have this size (power
+    // of 2).
+    //
+    size_t size;
+
+    std::vector<size_t> slots; // Entry index to table slot.
+    std::vector<unsigned long> disp;
+  };
+
+  // Hash-and-displace: keys are first distributed into buckets using the
+  // g hash. Then, starting with the largest bucket, we find for each
+  // bucket a displacement d such that (f + d) gives a free slot for all
+  // its keys. If that fails, we try different seeds and then a larger
+  // table.
+  //
+  bool
+  build_perfect_hash (option_entries const& es, perfect_hash& ph)
+  {
+    size_t n (es.size ());
+
+    std::vector<unsigned long> fs (n), gs (n);
+    std::vector<string> keys (n);
+
+    for (size_t i (0); i < n; ++i)
+      keys[i] = unescape (es[i].name);
+
+    for (ph.size = 1; ph.size < n; ph.size <<= 1) ;
+
+    for (; ph.size <= (1UL << 20); ph.size <<= 1)
+    {
+      size_t mask (ph.size - 1);
+
+      for (unsigned long t (0); t < 64; ++t)
+      {
+        ph.f_seed = (0x811C9DC5UL + t * 0x9E3779B9UL) & 0xFFFFFFFFUL;
+        ph.g_seed = (0x01000193UL ^ ((t + 1) * 0x85EBCA6BUL)) & 0xFFFFFFFFUL;
+
+        std::vector<std::vector<size_t> > buckets (ph.size);
+
+        for (size_t i (0); i < n; ++i)
+        {
+          unsigned long f (ph.f_seed), g (ph.g_seed);
+          string const& k (keys[i]);
+
+          for (size_t j (0), m (k.size ()); j < m; ++j)
+          {
+            unsigned long c (static_cast<unsigned char> (k[j]));
+            f = ((f ^ c) * 16777619UL) & 0xFFFFFFFFUL;
+            g = ((g ^ c) * 16777619UL) & 0xFFFFFFFFUL;
+          }
+
+          fs[i] = mix (f);
+          gs[i] = mix (g);
+          buckets[gs[i] & mask].push_back (i);
+        }
+
+        // Process buckets from the largest to the smallest.
+        //
+        std::vector<std::pair<size_t, size_t> > order;
+        for (size_t b (0); b < ph.size; ++b)
+          if (!buckets[b].empty ())
+            order.push_back (std::make_pair (ph.size - buckets[b].size (), b));
+
+        std::sort (order.begin (), order.end ());
+
+        std::vector<bool> used (ph.size, false);
+        ph.slots.assign (n, 0);
+        ph.disp.assign (ph.size, 0);
+
+        bool ok (true);
+
+        for (size_t o (0); ok && o < order.size (); ++o)
+        {
+          std::vector<size_t> const& b (buckets[order[o].second]);
+
+          ok = false;
+
+          for (unsigned long d (0); !ok && d < ph.size; ++d)
+          {
+            size_t j (0);
+
+            for (; j < b.size (); ++j)
+            {
+              size_t s ((fs[b[j]] + d) & mask);
+
+              if (used[s])
+                break;
+
+              used[s] = true;
+            }
+
+            if (j == b.size ())
+            {
+              for (j = 0; j < b.size (); ++j)
+                ph.slots[b[j]] = (fs[b[j]] + d) & mask;
+
+              ph.disp[order[o].second] = d;
+              ok = true;
+            }
+            else
+            {
+              // Undo.
+              //
+              while (j != 0)
+                used[(fs[b[--j]] + d) & mask] = false;
+            }
+          }
+        }
+
+        if (ok)
+          return true;
+      }
+    }
+
+    return false;
+  }
+
+  // Compare option names as std::strcmp() would, that is, as sequences
+  // of unsigned char.
+  //
+  bool
+  sorted_entry_less (std::pair<string, option_entry const*> const& x,
+                     std::pair<string, option_entry const*> const& y)
+  {
+    string const& a (x.first);
+    string const& b (y.first);
+
+    for (size_t i (0); i < a.size () && i < b.size (); ++i)
+    {
+      unsigned char ca (static_cast<unsigned char> (a[i]));
+      unsigned char cb (static_cast<unsigned char> (b[i]));
+
+      if (ca != cb)
+        return ca < cb;
+    }
+
+    return a.size () < b.size ();
+  }
+
+  // Return the option_desc value type for the C++ type of the option
+  // data member. Values of the other types are parsed by parse_value().
+  //
+  string
+  value_type (string const& t)
+  {
+    if (t == "bool")
+      return "bool_value";
+
+    if (t == "std::string")
+      return "string_value";
+
+    if (t == "int")
+      return "int_value";
+
+    if (t == "unsigned int")
+      return "unsigned_int_value";
+
+    if (t == "long")
+      return "long_value";
+
+    if (t == "unsigned long")
+      return "unsigned_long_value";
+
+    if (t == "double")
+      return "double_value";
+
+    if (t == "std::vector<std::string>")
+      return "string_vector_value";
+
+    return "other_value";
+  }
+
+
+  // Restore the default value of an option. Initializers are re-evaluated
+  // while options without one are reset with cli::reset_value() which
+  // retains the allocated memory where possible.
+  //
+  struct option_reset: traversal::option, context
+  {
+    option_reset (context& c) : context (c) {}
+
+    virtual void
+    traverse (type& o)
+    {
+      string member (emember (o));
+      string type (member_type (o));
+
+      // Packed bool options are reset together with the flags.
+      //
+      if (packed (o) && type == "bool")
+        return;
+
+      if (o.lazy ())
+        os << cli << "::reset_value (" << member << ");"
+           << elazy_member (o) << " = true;";
+      else if (o.initialized_p ())
+      {
+        using semantics::expression;
+        expression const& i (o.initializer ());
 
-        os << " >;";
+        switch (i.type ())
+        {
+        case expression::string_lit:
+        case expression::char_lit:
+        case expression::bool_lit:
+        case expression::int_lit:
+        case expression::float_lit:
+        case expression::identifier:
+          {
+            os << member << " = " << i.value () << ";";
+            break;
+          }
+        case expression::call_expr:
+          {
+            // Name the type with a typedef since the functional cast
+            // notation does not allow multi-word type names, such as
+            // unsigned int.
+            //
+            os << "{"
+               << "typedef " << type << " _cli_type;"
+               << member << " = _cli_type " << i.value () << ";"
+               << "}";
+            break;
+          }
+        }
       }
+      else if (!o.sink ()) // The sink function is retained.
+        os << cli << "::reset_value (" << member << ");";
+
+      if (specifier && type != "bool" && !packed (o))
+        os << especifier_member (o) << " = false;";
+    }
+  };
+
+  //
+  //
+  struct base_reset: traversal::class_, context
+  {
+    base_reset (context& c): context (c) {}
+
+    virtual void
+    traverse (type& c)
+    {
+      os << "// " << escape (c.name ()) << " base" << endl
+         << "//" << endl
+         << fq_name (c) << "::reset ();"
+         << endl;
     }
   };
 
@@ -428,23 +948,6 @@ namespace
     size_t length_;
   };
 
-  //
-  //
-  struct base_parse: traversal::class_, context
-  {
-    base_parse (context& c): context (c) {}
-
-    virtual void
-    traverse (type& c)
-    {
-      os << "// " << escape (c.name ()) << " base" << endl
-         << "//" << endl
-         << "if (" << fq_name (c) << "::_parse (o, s))" << endl
-         << "return true;"
-         << endl;
-    }
-  };
-
   //
   //
   struct base_desc: traversal::class_, context
@@ -481,16 +984,14 @@ namespace
   {
     class_ (context& c)
         : context (c),
-          base_parse_ (c),
+          base_reset_ (c),
           base_desc_ (c),
           base_usage_ (c),
-          option_map_ (c),
           option_desc_ (c)
     {
-      inherits_base_parse_ >> base_parse_;
+      inherits_base_reset_ >> base_reset_;
       inherits_base_desc_ >> base_desc_;
       inherits_base_usage_ >> base_usage_;
-      names_option_map_ >> option_map_;
       names_option_desc_ >> option_desc_;
     }
 
@@ -503,6 +1004,26 @@ namespace
       bool ho (has<semantics::option> (c));
       bool hb (c.inherits_begin () != c.inherits_end ());
 
+      // The sink function has to be set before parsing which is only
+      // possible with the default c-tor and parse().
+      //
+      if (!options.generate_parse ())
+      {
+        for (type::names_iterator i (c.names_begin ());
+             i != c.names_end (); ++i)
+        {
+          semantics::option* o (
+            dynamic_cast<semantics::option*> (&i->named ()));
+
+          if (o != 0 && o->sink ())
+          {
+            cerr << o->file () << ":" << o->line () << ":" << o->column ()
+                 << " error: sink option requires --generate-parse" << endl;
+            throw generation_failed ();
+          }
+        }
+      }
+
       os << "// " << name << endl
          << "//" << endl
          << endl;
@@ -518,93 +1039,110 @@ namespace
         traversal::names names_init (init);
         names (c, names_init);
       }
-      os << "{"
-         << "}";
+      os << "{";
+      flag_init (c);
+      os << "}";
 
       if (!abst)
       {
-        os << name << "::" << endl
-           << name << " (int& argc," << endl
-           << "char** argv," << endl
-           << "bool erase," << endl
-           << um << " opt," << endl
-           << um << " arg)";
+        if (!options.suppress_exceptions ())
         {
-          option_init init (*this);
-          traversal::names names_init (init);
-          names (c, names_init);
-        }
-        os << "{"
-           << cli << "::argv_scanner s (argc, argv, erase);"
-           << "_parse (s, opt, arg);"
-           << "}";
+          os << name << "::" << endl
+             << name << " (int& argc," << endl
+             << "char** argv," << endl
+             << "bool erase," << endl
+             << um << " opt," << endl
+             << um << " arg)";
+          ctor_init (c, name);
+          os << cli << "::argv_scanner s (argc, argv, erase);"
+             << "_parse (s, opt, arg);"
+             << "}";
 
-        os << name << "::" << endl
-           << name << " (int start," << endl
-           << "int& argc," << endl
-           << "char** argv," << endl
-           << "bool erase," << endl
-           << um << " opt," << endl
-           << um << " arg)";
-        {
-          option_init init (*this);
-          traversal::names names_init (init);
-          names (c, names_init);
-        }
-        os << "{"
-           << cli << "::argv_scanner s (start, argc, argv, erase);"
-           << "_parse (s, opt, arg);"
-           << "}";
+          os << name << "::" << endl
+             << name << " (int start," << endl
+             << "int& argc," << endl
+             << "char** argv," << endl
+             << "bool erase," << endl
+             << um << " opt," << endl
+             << um << " arg)";
+          ctor_init (c, name);
+          os << cli << "::argv_scanner s (start, argc, argv, erase);"
+             << "_parse (s, opt, arg);"
+             << "}";
 
-        os << name << "::" << endl
-           << name << " (int& argc," << endl
-           << "char** argv," << endl
-           << "int& end," << endl
-           << "bool erase," << endl
-           << um << " opt," << endl
-           << um << " arg)";
-        {
-          option_init init (*this);
-          traversal::names names_init (init);
-          names (c, names_init);
-        }
-        os << "{"
-           << cli << "::argv_scanner s (argc, argv, erase);"
-           << "_parse (s, opt, arg);"
-           << "end = s.end ();"
-           << "}";
+          os << name << "::" << endl
+             << name << " (int& argc," << endl
+             << "char** argv," << endl
+             << "int& end," << endl
+             << "bool erase," << endl
+             << um << " opt," << endl
+             << um << " arg)";
+          ctor_init (c, name);
+          os << cli << "::argv_scanner s (argc, argv, erase);"
+             << "_parse (s, opt, arg);"
+             << "s.compact ();"
+             << "end = s.end ();"
+             << "}";
 
-        os << name << "::" << endl
-           << name << " (int start," << endl
-           << "int& argc," << endl
-           << "char** argv," << endl
-           << "int& end," << endl
-           << "bool erase," << endl
-           << um << " opt," << endl
-           << um << " arg)";
-        {
-          option_init init (*this);
-          traversal::names names_init (init);
-          names (c, names_init);
+          os << name << "::" << endl
+             << name << " (int start," << endl
+             << "int& argc," << endl
+             << "char** argv," << endl
+             << "int& end," << endl
+             << "bool erase," << endl
+             << um << " opt," << endl
+             << um << " arg)";
+          ctor_init (c, name);
+          os << cli << "::argv_scanner s (start, argc, argv, erase);"
+             << "_parse (s, opt, arg);"
+             << "s.compact ();"
+             << "end = s.end ();"
+             << "}";
         }
-        os << "{"
-           << cli << "::argv_scanner s (start, argc, argv, erase);"
-           << "_parse (s, opt, arg);"
-           << "end = s.end ();"
-           << "}";
 
         os << name << "::" << endl
            << name << " (" << cli << "::scanner& s," << endl
            << um << " opt," << endl
            << um << " arg)";
+        ctor_init (c, name);
+        os << "_parse (s, opt, arg);"
+           << "}";
+      }
+
+      // reset () and parse ()
+      //
+      if (options.generate_parse ())
+      {
+        os << "void " << name << "::" << endl
+           << "reset ()"
+           << "{";
+
+        inherits (c, inherits_base_reset_);
+
+        if (flag_count (c) != 0)
+          os << eflags_member (c) << ".reset ();";
+
+        if (presence_count (c) != 0)
+          os << epresence_member (c) << ".reset ();";
+
+        flag_init (c);
+
         {
-          option_init init (*this);
-          traversal::names names_init (init);
-          names (c, names_init);
+          option_reset t (*this);
+          traversal::names n (t);
+          names (c, n);
         }
-        os << "{"
-           << "_parse (s, opt, arg);"
-           << "}";
+
+        os << "}";
+
+        if (!abst)
+          os << "void " << name << "::" << endl
+             << "parse (" << cli << "::scanner& s," << endl
+             << um << " opt," << endl
+             << um << " arg)"
+             << "{"
+             << "_parse (s, opt, arg);"
+             << "}";
       }
 
       // Usage.
@@ -716,21 +1254,17 @@ namespace
       {
         string desc ("_cli_" + name + "_desc");
 
-        os << "static " << cli << "::options " << desc << "_;"
-           << endl;
-
+        // Built on first use, the same as the lookup map.
+        //
         os << "struct " << desc << "_init"
            << "{"
-           << desc << "_init (" << cli << "::options& os)"
+           << desc << "_init ()"
            << "{"
            << name << "::fill (os);"
            << "}"
+           << cli << "::options os;"
            << "};";
 
-        os << "static " << desc << "_init " << desc << "_init_ (" <<
-          desc << "_);"
-           << endl;
-
         os << "void " << name << "::" << endl
            << "fill (" << cli << "::options& " << (ho || hb ? " os)" : ")")
            << "{";
@@ -746,56 +1280,47 @@ namespace
         os << "const " << cli << "::options& " << name << "::" << endl
            << "description ()"
            << "{"
-           << "return " << desc << "_;"
+           << "static const " << desc << "_init d;"
+           << "return d.os;"
            << "};";
       }
 
-      // _parse ()
+      // _validate ()
       //
-      string map ("_cli_" + name + "_map");
-
-      os << "typedef" << endl
-         << "std::map<std::string, void (*) (" <<
-        name << "&, " << cli << "::scanner&)>" << endl
-         << map << ";"
-         << endl
-         << "static " << map << " " << map << "_;"
-         << endl;
+      if (validated (c))
+        validate (c);
 
-      os << "struct " << map << "_init"
-         << "{"
-         << map << "_init ()"
-         << "{";
-
-      names (c, names_option_map_);
+      // _parse ()
+      //
+      // The lookup table contains the options of this class as well as
+      // of all its bases so that any option in the hierarchy is found
+      // with a single lookup.
+      //
+      {
+        string const& l (options.option_lookup ());
 
-      os << "}"
-         << "};"
-         << "static " << map << "_init " << map << "_init_;"
-         << endl;
+        if (l == "hash")
+          parse_hash (c);
+        else if (l == "sorted")
+          parse_sorted (c);
+        else
+          parse_map (c);
+      }
 
-      os << "bool " << name << "::" << endl
-         << "_parse (const char* o, " << cli << "::scanner& s)"
-         << "{"
-         << map << "::const_iterator i (" << map << "_.find (o));"
-         << endl
-         << "if (i != " << map << "_.end ())"
-         << "{"
-         << "(*(i->second)) (*this, s);"
-         << "return true;"
+      os << "return false;"
          << "}";
 
-      // Try our bases, from left-to-right.
+      // _parse_bundle ()
       //
-      inherits (c, inherits_base_parse_);
-
-      os << "return false;"
-         << "}";
+      if (!abst && options.bundle_short_options ())
+        parse_bundle (c);
 
       if (!abst)
       {
         bool pfx (!opt_prefix.empty ());
         bool sep (!opt_sep.empty ());
+        bool ne (options.suppress_exceptions ());
+        string err (cli + "::error");
 
         os << "void " << name << "::" << endl
            << "_parse (" << cli << "::scanner& s," << endl
@@ -807,8 +1332,15 @@ namespace
           os << "bool opt = true;" // Still recognizing options.
              << endl;
 
-        os << "while (s.more ())"
-           << "{"
+        // Without exceptions, stop as soon as an error is recorded.
+        //
+        if (ne)
+          os << "while (s.error ().code () == " << err << "::none && " <<
+            "s.more ())";
+        else
+          os << "while (s.more ())";
+
+        os << "{"
            << "const char* o = s.peek ();";
 
         if (sep)
@@ -822,6 +1354,12 @@ namespace
 
         os << "if (" << (sep ? "opt && " : "") << "_parse (o, s));";
 
+        if (options.bundle_short_options ())
+          os << "else if (" << (sep ? "opt && " : "") <<
+            "o[0] == '-' && o[1] != '-' && o[1] != '\\0' && " <<
+            "o[2] != '\\0' &&" << endl
+             << "_parse_bundle (s));";
+
         // Unknown option.
         //
         if (pfx)
@@ -849,7 +1387,9 @@ namespace
              << "}"
              << "case " << cli << "::unknown_mode::fail:" << endl
              << "{"
-             << "throw " << cli << "::unknown_option (o);"
+             << (ne
+               ? "s.fail (" + err + " (" + err + "::unknown_option, o));return;"
+               : "throw " + cli + "::unknown_option (o);")
              << "}"
              << "}" // switch
              << "break;" // The stop case.
@@ -873,20 +1413,817 @@ namespace
            << "}"
            << "case " << cli << "::unknown_mode::fail:" << endl
            << "{"
-           << "throw " << cli << "::unknown_argument (o);"
+           << (ne
+               ? "s.fail (" + err + " (" + err + "::unknown_argument, o));return;"
+               : "throw " + cli + "::unknown_argument (o);")
            << "}"
            << "}" // switch
            << "break;" // The stop case.
            << "}"
 
-           << "}" // for
+           << "}"; // for
+
+        // Check the constraints of the bases and then our own.
+        //
+        if (validated (c))
+        {
+          if (ne)
+            os << "if (s.error ().code () == " << err << "::none)" << endl;
+
+          os << "_validate (s);";
+        }
+
+        os << "}";
+      }
+    }
+
+  private:
+    // Check the constraints of the direct bases, each of which checks
+    // its own bases, so that every base subobject is checked, including
+    // the several subobjects of a non-virtual diamond. Then compile each
+    // of our constraints into a test of the presence mask against the
+    // mask of the options it references.
+    //
+    void
+    validate (type& c)
+    {
+      typedef semantics::class_::constraint_list constraints;
+      typedef std::vector<semantics::option*> option_list;
+
+      string name (escape (c.name ()));
+      bool ne (options.suppress_exceptions ());
+      string err (cli + "::error");
+      size_t n (presence_count (c));
+      constraints const& cs (c.constraints ());
+
+      bool bases (false);
+      for (type::inherits_iterator i (c.inherits_begin ());
+           i != c.inherits_end ();
+           ++i)
+        bases = bases || validated (i->base ());
+
+      os << "void " << name << "::" << endl
+         << "_validate (" << cli << "::scanner&" <<
+        (ne || bases ? " s" : "") << ") const"
+         << "{";
+
+      // Without exceptions, stop at the first violation.
+      //
+      bool first (true);
+      for (type::inherits_iterator i (c.inherits_begin ());
+           i != c.inherits_end ();
+           ++i)
+      {
+        type& b (i->base ());
+
+        if (!validated (b))
+          continue;
+
+        if (ne && !first)
+          os << "if (s.error ().code () != " << err << "::none)" << endl
+             << "return;"
+             << endl;
+
+        os << fq_name (b) << "::_validate (s);";
+        first = false;
+      }
+
+      if (n == 0)
+      {
+        os << "}";
+        return;
+      }
+
+      if (ne && bases)
+        os << "if (s.error ().code () != " << err << "::none)" << endl
+           << "return;"
+           << endl;
+
+      // Option names by presence bit for reporting conflicts.
+      //
+      bool ex (false);
+      for (constraints::const_iterator i (cs.begin ()); i != cs.end (); ++i)
+        ex = ex || i->exclusive;
+
+      if (ex)
+      {
+        std::vector<string> ns (n);
+
+        for (type::names_iterator i (c.names_begin ());
+             i != c.names_end (); ++i)
+        {
+          semantics::option* o (
+            dynamic_cast<semantics::option*> (&i->named ()));
+
+          if (o != 0 && presence_p (*o))
+            ns[presence_bit (*o)] = o->name ();
+        }
+
+        os << "static const char* const n[] = {";
+
+        for (size_t i (0); i != n; ++i)
+          os << (i != 0 ? ", " : "") << "\"" << ns[i] << "\"";
+
+        os << "};";
+      }
+
+      os << "const " << cli << "::flag_set< " << n << " >& p (this->" <<
+        epresence_member (c) << ");"
+         << cli << "::flag_set< " << n << " > m;";
+
+      for (constraints::const_iterator i (cs.begin ()); i != cs.end (); ++i)
+      {
+        option_list const& ol (i->options);
+
+        string on;
+        for (option_list::const_iterator j (ol.begin ()); j != ol.end (); ++j)
+          on += (j != ol.begin () ? "|" : "") + (*j)->name ();
+
+        os << endl
+           << "// ";
+
+        if (i->dependent != 0)
+          os << "depends " << i->dependent->name () << ": ";
+        else if (i->required)
+          os << "required ";
+
+        if (i->exclusive)
+          os << "exclusive ";
+
+        os << on << endl
+           << "//" << endl
+           << "m.reset ();";
+
+        for (option_list::const_iterator j (ol.begin ()); j != ol.end (); ++j)
+          os << "m.set (" << presence_bit (**j) << ");";
+
+        if (i->dependent != 0)
+          os << "if (p.test (" << presence_bit (*i->dependent) << "))"
+             << "{";
+
+        if (i->required)
+        {
+          os << "if (!p.any (m))"
+             << "{";
+
+          if (ne)
+            os << "s.fail (" << err << " (" << err << "::missing_option, \"" <<
+              on << "\"));"
+               << "return;";
+          else
+            os << "throw " << cli << "::missing_option (\"" << on << "\");";
+
+          os << "}";
+        }
+
+        if (i->exclusive)
+        {
+          os << "if (p.count (m) > 1)"
+             << "{"
+             << "std::size_t i (p.find (m));";
+
+          if (ne)
+            os << "s.fail (" << err << " (" << err << "::option_conflict, " <<
+              "n[i], n[p.find (m, i + 1)]));"
+               << "return;";
+          else
+            os << "throw " << cli << "::option_conflict (n[i], " <<
+              "n[p.find (m, i + 1)]);";
+
+          os << "}";
+        }
+
+        if (i->dependent != 0)
+          os << "}";
+      }
+
+      os << "}";
+    }
+
+    void
+    flag_init (type& c)
+    {
+      option_flag_init i (*this);
+      traversal::names n (i);
+      names (c, n);
+    }
+
+    // Emit the member initializer list and the opening of the body of a
+    // parsing c-tor. With C++11 the parsing c-tors delegate to the default
+    // c-tor instead of repeating the option initializers in each of them.
+    //
+    void
+    ctor_init (type& c, string const& name)
+    {
+      if (cxx11)
+      {
+        os << endl
+           << ": " << name << " ()"
+           << "{";
+        return;
+      }
+
+      {
+        option_init init (*this);
+        traversal::names names_init (init);
+        names (c, names_init);
+      }
+
+      os << "{";
+      flag_init (c);
+    }
+
+    // Return the options of this class followed by those of its bases,
+    // from left to right and depth-first. If several options in the
+    // hierarchy have the same name, then the first one wins.
+    //
+    option_entries
+    entries (type& c)
+    {
+      option_entries es, r;
+      option_entries_collector::path_type p (1, &c);
+      collect (c, p, es);
+
+      std::set<string> seen;
+
+      for (option_entries::const_iterator i (es.begin ());
+           i != es.end ();
+           ++i)
+      {
+        if (seen.insert (unescape (i->name)).second)
+          r.push_back (*i);
+      }
+
+      return r;
+    }
+
+    void
+    collect (type& c,
+             option_entries_collector::path_type& p,
+             option_entries& es)
+    {
+      {
+        option_entries_collector ec (*this, es, p);
+        traversal::names n (ec);
+        names (c, n);
+      }
+
+      for (type::inherits_iterator i (c.inherits_begin ());
+           i != c.inherits_end ();
+           ++i)
+      {
+        p.push_back (&i->base ());
+        collect (i->base (), p, es);
+        p.pop_back ();
+      }
+    }
+
+    // With the table backend, each option in the hierarchy has an index
+    // in the parsing switch of the class. Several names of the same
+    // option share the index.
+    //
+    typedef std::map<semantics::option*, size_t> option_indexes;
+
+    static option_indexes
+    indexes (option_entries const& es)
+    {
+      option_indexes r;
+
+      for (option_entries::const_iterator i (es.begin ());
+           i != es.end ();
+           ++i)
+        r.insert (std::make_pair (i->option, r.size ()));
+
+      return r;
+    }
+
+    // Return the option_desc initializer for the entry.
+    //
+    string
+    desc (option_entry const& e, option_indexes const& is)
+    {
+      semantics::option& o (*e.option);
+
+      std::ostringstream r;
+      r << "{\"" << e.name << "\", " << unescape (e.name).size () << ", " <<
+        is.find (&o)->second << ", " <<
+        cli << "::option_desc::" << value_type (member_type (o)) << ", " <<
+        (packed (o) ? flag_bit (o) : 0) << ", " <<
+        (presence_p (o) ? presence_bit (o) : 0) << "}";
+
+      return r.str ();
+    }
+
+    void
+    desc_table (option_entries const& es,
+                option_indexes const& is,
+                string const& table)
+    {
+      if (es.empty ())
+        return;
+
+      os << "static const " << cli << "::option_desc " << table << "[" <<
+        es.size () << "] ="
+         << "{";
+
+      for (option_entries::const_iterator i (es.begin ());
+           i != es.end ();
+           ++i)
+      {
+        if (i != es.begin ())
+          os << "," << endl;
+
+        os << desc (*i, is);
+      }
+
+      os << "};";
+    }
+
+    // Emit the code that locates the option described by the option_desc
+    // expression d in this object and passes it to parse_option().
+    //
+    void
+    dispatch (option_entries const& es,
+              option_indexes const& is,
+              string const& d)
+    {
+      os << "const " << cli << "::option_desc& d (" << d << ");"
+         << cli << "::option_ref r = {0, 0, 0, 0, 0, 0};"
+         << endl
+         << "switch (d.index)"
+         << "{";
+
+      std::set<semantics::option*> done;
+
+      for (option_entries::const_iterator i (es.begin ());
+           i != es.end ();
+           ++i)
+      {
+        if (!done.insert (i->option).second)
+          continue;
+
+        semantics::option& o (*i->option);
+        semantics::scope& s (o.scope ());
+        string const& x (i->object);
+        string type (member_type (o));
+        bool p (packed (o));
+
+        os << "case " << is.find (&o)->second << ":" << endl
+           << "{";
+
+        if (!p || type != "bool")
+          os << "r.value = &" << x << emember (o) << ";";
+
+        if (specifier && type != "bool" && !p)
+          os << "r.specifier = &" << x << especifier_member (o) << ";";
+
+        if (o.lazy ())
+          os << "r.lazy = &" << x << elazy_member (o) << ";";
+
+        if (p)
+          os << "r.flags = " << x << eflags_member (s) << ".data ();";
+
+        if (presence_p (o))
+          os << "r.presence = " << x << epresence_member (s) << ".data ();";
+
+        if (value_type (type) == "other_value")
+          os << "r.parse = &" << cli << "::parse_value< " << type << " >;";
+
+        os << "break;"
+           << "}";
+      }
+
+      os << "}"
+         << cli << "::parse_option (d, r, s);";
+    }
+
+    void
+    parse_map (type& c)
+    {
+      string name (escape (c.name ()));
+      string map ("_cli_" + name + "_map");
+
+      if (tabular)
+      {
+        parse_map_table (c);
+        return;
+      }
+
+      os << "typedef" << endl
+         << "std::map<std::string, void (*) (" <<
+        name << "&, " << cli << "::scanner&)>" << endl
+         << map << ";"
+         << endl;
+
+      // The map is built on first use by a function-local static so that
+      // it does not depend on the static initialization order and, in
+      // C++11, is safe to initialize from multiple threads.
+      //
+      os << "static " << map << endl
+         << map << "_init ()"
+         << "{"
+         << map << " m;";
+
+      option_entries es (entries (c));
+
+      for (option_entries::const_iterator i (es.begin ());
+           i != es.end ();
+           ++i)
+        os << "m[\"" << i->name << "\"] = " << endl
+           << i->thunk << ";";
+
+      os << "return m;"
+         << "}";
+
+      os << "bool " << name << "::" << endl
+         << "_parse (const char* o, " << cli << "::scanner& s)"
+         << "{"
+         << "static const " << map << " m (" << map << "_init ());"
+         << endl
+         << map << "::const_iterator i (m.find (o));"
+         << endl
+         << "if (i != m.end ())"
+         << "{"
+         << "(*(i->second)) (*this, s);"
+         << "return true;"
+         << "}";
+    }
+
+    void
+    parse_map_table (type& c)
+    {
+      string name (escape (c.name ()));
+      string map ("_cli_" + name + "_map");
+      string table ("_cli_" + name + "_table_");
+
+      option_entries es (entries (c));
+      option_indexes is (indexes (es));
+
+      desc_table (es, is, table);
+
+      os << "typedef" << endl
+         << "std::map<std::string, const " << cli << "::option_desc*>" << endl
+         << map << ";"
+         << endl;
+
+      os << "static " << map << endl
+         << map << "_init ()"
+         << "{"
+         << map << " m;";
+
+      for (size_t i (0); i < es.size (); ++i)
+        os << "m[\"" << es[i].name << "\"] = " << table << " + " << i << ";";
+
+      os << "return m;"
+         << "}";
+
+      os << "bool " << name << "::" << endl
+         << "_parse (const char* o, " << cli << "::scanner& s)"
+         << "{"
+         << "static const " << map << " m (" << map << "_init ());"
+         << endl
+         << map << "::const_iterator i (m.find (o));"
+         << endl
+         << "if (i != m.end ())"
+         << "{";
+
+      dispatch (es, is, "*i->second");
+
+      os << "return true;"
+         << "}";
+    }
+
+    void
+    parse_hash (type& c)
+    {
+      string name (escape (c.name ()));
+      string table ("_cli_" + name + "_table_");
+      string disp ("_cli_" + name + "_disp_");
+
+      option_entries es (entries (c));
+      option_indexes is;
+
+      if (tabular)
+        is = indexes (es);
+
+      // Table entry type.
+      //
+      string et (tabular ? cli + "::option_desc" :
+                 cli + "::option_entry< " + name + " >");
+
+      perfect_hash ph;
+
+      if (!es.empty () && !build_perfect_hash (es, ph))
+      {
+        cerr << c.file () << ":" << c.line () << ":" << c.column ()
+             << " error: unable to construct perfect hash table for "
+             << "class '" << c.name () << "'" << endl;
+        throw generation_failed ();
+      }
+
+      if (!es.empty ())
+      {
+        std::vector<option_entry const*> slots (ph.size, 0);
+
+        for (size_t i (0); i < es.size (); ++i)
+          slots[ph.slots[i]] = &es[i];
+
+        os << "static " << (cxx17 ? "constexpr " : "const ") << et << " " <<
+          table << "[" << ph.size << "] ="
+           << "{";
+
+        for (size_t i (0); i < ph.size; ++i)
+        {
+          if (i != 0)
+            os << "," << endl;
+
+          if (option_entry const* e = slots[i])
+          {
+            if (tabular)
+              os << desc (*e, is);
+            else
+              os << "{\"" << e->name << "\", " <<
+                unescape (e->name).size () << ", " << e->thunk << "}";
+          }
+          else
+            os << (tabular ? "{0, 0, 0, 0, 0, 0}" : "{0, 0, 0}");
+        }
+
+        os << "};";
+
+        os << "static " << (cxx17 ? "constexpr " : "const ") <<
+          "unsigned long " << disp << "[" << ph.size << "] ="
+           << "{";
+
+        for (size_t i (0); i < ph.size; ++i)
+        {
+          if (i != 0)
+            os << (i % 8 == 0 ? ",\n" : ", ");
+
+          os << ph.disp[i] << "UL";
+        }
+
+        os << "};";
+
+        if (cxx17)
+          os << "static_assert (" << cli << "::option_unique (" << table <<
+            ", " << ph.size << ", " << ph.f_seed << "UL, " << ph.g_seed <<
+            "UL, " << disp << ")," << endl
+             << "\"duplicate option name\");"
+             << endl;
+      }
+
+      // If we have no options, then the arguments are unused.
+      //
+      bool u (!es.empty ());
+
+      os << "bool " << name << "::" << endl
+         << "_parse (const char*" << (u ? " o" : "") << ", " <<
+        cli << "::scanner&" << (u ? " s" : "") << ")"
+         << "{";
+
+      if (!es.empty ())
+      {
+        size_t mask (ph.size - 1);
+
+        os << "std::size_t n;"
+           << "unsigned long f (" << ph.f_seed << "UL), g (" <<
+          ph.g_seed << "UL);"
+           << cli << "::option_hash (o, n, f, g);"
+           << endl
+           << "const " << et << "& e (" << endl
+           << table << "[(f + " << disp << "[g & " << mask << "]) & " <<
+          mask << "]);"
+           << endl
+           << "if (e.name != 0 && e.size == n && " <<
+          "std::memcmp (o, e.name, n) == 0)"
+           << "{";
+
+        if (tabular)
+          dispatch (es, is, "e");
+        else
+          os << "(*e.thunk) (*this, s);";
+
+        os << "return true;"
+           << "}";
+      }
+    }
+
+    void
+    parse_sorted (type& c)
+    {
+      string name (escape (c.name ()));
+      string table ("_cli_" + name + "_table_");
+
+      option_entries es (entries (c));
+      option_indexes is;
+
+      if (tabular)
+        is = indexes (es);
+
+      // Table entry type.
+      //
+      string et (tabular ? cli + "::option_desc" :
+                 cli + "::option_entry< " + name + " >");
+
+      // Sort the entries in the std::strcmp() order of the option names
+      // as seen by the C++ compiler.
+      //
+      typedef std::vector<std::pair<string, option_entry const*> > sorted;
+      sorted se;
+
+      for (size_t i (0); i < es.size (); ++i)
+        se.push_back (std::make_pair (unescape (es[i].name), &es[i]));
+
+      std::sort (se.begin (), se.end (), sorted_entry_less);
+
+      if (!se.empty ())
+      {
+        os << "static " << (cxx17 ? "constexpr " : "const ") << et << " " <<
+          table << "[" << se.size () << "] ="
+           << "{";
+
+        for (sorted::const_iterator i (se.begin ()); i != se.end (); ++i)
+        {
+          if (i != se.begin ())
+            os << "," << endl;
+
+          if (tabular)
+            os << desc (*i->second, is);
+          else
+            os << "{\"" << i->second->name << "\", " << i->first.size () <<
+              ", " << i->second->thunk << "}";
+        }
+
+        os << "};";
+
+        if (cxx17)
+          os << "static_assert (" << cli << "::option_sorted (" << table <<
+            ", " << se.size () << ")," << endl
+             << "\"duplicate or unsorted option name\");"
+             << endl;
+      }
+
+      // If we have no options, then the arguments are unused.
+      //
+      bool u (!es.empty ());
+
+      os << "bool " << name << "::" << endl
+         << "_parse (const char*" << (u ? " o" : "") << ", " <<
+        cli << "::scanner&" << (u ? " s" : "") << ")"
+         << "{";
+
+      if (!se.empty ())
+      {
+        os << "if (const " << et << "* e =" << endl
+           << cli << "::option_search (" << table << ", " << se.size () <<
+          ", o))"
+           << "{";
+
+        if (tabular)
+          dispatch (es, is, "*e");
+        else
+          os << "(*e->thunk) (*this, s);";
+
+        os << "return true;"
+           << "}";
+      }
+    }
+
+    // Single-character options are looked up in a direct table indexed by
+    // the character which contains the index of the option in the bundle
+    // table plus one or 0 if there is no such option. The bool options
+    // come first in the bundle table so that whether an option takes a
+    // value is a single comparison of its index.
+    //
+    void
+    parse_bundle (type& c)
+    {
+      string name (escape (c.name ()));
+      string index ("_cli_" + name + "_short_");
+      string table ("_cli_" + name + "_short_table_");
+      bool ne (options.suppress_exceptions ());
+      string err (cli + "::error");
+
+      option_entries es (entries (c)), ss, vs;
+
+      for (option_entries::const_iterator i (es.begin ());
+           i != es.end ();
+           ++i)
+      {
+        string n (unescape (i->name));
+
+        if (n.size () == 2 && n[0] == '-' && n[1] != '-')
+          (i->option->type ().name () == "bool" ? ss : vs).push_back (*i);
+      }
+
+      size_t flags (ss.size ());
+      ss.insert (ss.end (), vs.begin (), vs.end ());
+
+      // If we have no single-character options, then there is nothing
+      // to bundle.
+      //
+      if (ss.empty ())
+      {
+        os << "bool " << name << "::" << endl
+           << "_parse_bundle (" << cli << "::scanner&)"
+           << "{"
+           << "return false;"
            << "}";
+        return;
+      }
+
+      std::vector<size_t> is (256, 0);
+
+      for (size_t i (0); i < ss.size (); ++i)
+        is[static_cast<unsigned char> (unescape (ss[i].name)[1])] = i + 1;
+
+      os << "static const unsigned char " << index << "[256] ="
+         << "{";
+
+      for (size_t i (0); i < is.size (); ++i)
+      {
+        if (i != 0)
+          os << (i % 16 == 0 ? ",\n" : ", ");
+
+        os << is[i];
+      }
+
+      os << "};";
+
+      option_indexes ois;
+
+      if (tabular)
+      {
+        ois = indexes (ss);
+        desc_table (ss, ois, table);
+      }
+      else
+      {
+        os << "static void (* const " << table << "[" << ss.size () <<
+          "]) (" << name << "&, " << cli << "::scanner&) ="
+           << "{";
+
+        for (size_t i (0); i < ss.size (); ++i)
+          os << (i != 0 ? ",\n" : "") << ss[i].thunk;
+
+        os << "};";
       }
+
+      // Check the whole bundle before consuming it so that a bundle with
+      // an unknown option is left in place and handled as an unknown
+      // option by _parse(). An option that takes a value ends the check
+      // since the rest of the bundle is its value. As a result, every
+      // option scanned from the bundle below is known.
+      //
+      os << "bool " << name << "::" << endl
+         << "_parse_bundle (" << cli << "::scanner& x)"
+         << "{"
+         << "for (const char* p (x.peek () + 1); *p != '\\0'; ++p)"
+         << "{"
+         << "std::size_t i (" << index << "[static_cast<unsigned char> (*p)]);"
+         << endl
+         << "if (i == 0)" << endl
+         << "return false;";
+
+      if (flags != ss.size ())
+        os << endl
+           << "if (i > " << flags << ")" << endl
+           << "break;";
+
+      os << "}"
+         << cli << "::bundle_scanner s (x);"
+         << endl
+         << "for (;;)"
+         << "{"
+         << "std::size_t i (" << index << "[" << endl
+         << "static_cast<unsigned char> (s.option ())]);"
+         << endl;
+
+      if (tabular)
+        dispatch (ss, ois, table + "[i - 1]");
+      else
+        os << "(*" << table << "[i - 1]) (*this, s);";
+
+      if (ne)
+        os << endl
+           << "if (s.error ().code () != " << err << "::none)"
+           << "{"
+           << "x.fail (s.error ());"
+           << "break;"
+           << "}";
+
+      os << endl
+         << "if (!s.advance ())" << endl
+         << "break;"
+         << "}"
+         << "return true;"
+         << "}";
     }
 
   private:
-    base_parse base_parse_;
-    traversal::inherits inherits_base_parse_;
+    base_reset base_reset_;
+    traversal::inherits inherits_base_reset_;
 
     base_desc base_desc_;
     traversal::inherits inherits_base_desc_;
@@ -894,9 +2231,6 @@ namespace
     base_usage base_usage_;
     traversal::inherits inherits_base_usage_;
 
-    option_map option_map_;
-    traversal::names names_option_map_;
-
     option_desc option_desc_;
     traversal::names names_option_desc_;
   };
@@ -905,8 +2239,10 @@ namespace
 void
 generate_source (context& ctx)
 {
-  ctx.os << "#include <map>" << endl
-         << "#include <cstring>" << endl
+  if (ctx.options.option_lookup () == "map")
+    ctx.os << "#include <map>" << endl;
+
+  ctx.os << "#include <cstring>" << endl
          << endl;
 
   traversal::cli_unit unit;
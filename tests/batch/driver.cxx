@@ -0,0 +1,123 @@
+// file      : tests/batch/driver.cxx
+// author    : Boris Kolpackov <boris@codesynthesis.com>
+// copyright : Copyright (c) 2009-2011 Code Synthesis Tools CC
+// license   : MIT; see accompanying LICENSE file
+
+// Test parallel batch parsing.
+//
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <cassert>
+
+#include "test.hxx"
+
+using namespace std;
+
+typedef vector<string> args;
+
+int
+main ()
+{
+  // Generate command lines, some of them invalid.
+  //
+  vector<args> lines;
+
+  for (size_t i (0); i != 5000; ++i)
+  {
+    ostringstream l, n;
+    l << i;
+    n << "name-" << i;
+
+    args a;
+
+    if (i % 3 == 0)
+      a.push_back ("-v");
+
+    a.push_back ("--level");
+    a.push_back (i % 97 == 0 ? "x" : l.str ());
+
+    for (size_t j (0); j != i % 7; ++j)
+      a.push_back ("-I"), a.push_back (n.str ());
+
+    if (i % 101 == 0)
+      a.push_back ("--unknown");
+
+    a.push_back ("--name");
+
+    if (i % 89 != 0)
+      a.push_back (n.str ());
+
+    lines.push_back (a);
+  }
+
+  for (unsigned int t (0); t != 5; ++t)
+  {
+    vector<cli::parse_result<options> > r (
+      cli::parse_batch<options> (lines.begin (), lines.end (), t));
+
+    assert (r.size () == lines.size ());
+
+    for (size_t i (0); i != r.size (); ++i)
+    {
+      const options& o (r[i].options);
+
+      if (i % 97 == 0)
+      {
+        try
+        {
+          rethrow_exception (r[i].error);
+        }
+        catch (const cli::invalid_value& e)
+        {
+          assert (e.option () == "--level" && e.value () == "x");
+        }
+
+        continue;
+      }
+
+      if (i % 101 == 0)
+      {
+        try
+        {
+          rethrow_exception (r[i].error);
+        }
+        catch (const cli::unknown_option& e)
+        {
+          assert (e.option () == "--unknown");
+        }
+
+        continue;
+      }
+
+      if (i % 89 == 0)
+      {
+        try
+        {
+          rethrow_exception (r[i].error);
+        }
+        catch (const cli::missing_value& e)
+        {
+          assert (e.option () == "--name");
+        }
+
+        continue;
+      }
+
+      ostringstream n;
+      n << "name-" << i;
+
+      assert (!r[i].error);
+      assert (o.verbose () == (i % 3 == 0));
+      assert (o.level () == static_cast<int> (i));
+      assert (o.name () == n.str ());
+      assert (o.I ().size () == i % 7);
+    }
+  }
+
+  // Empty range.
+  //
+  assert (cli::parse_batch<options> (lines.begin (),
+                                     lines.begin ()).empty ());
+}
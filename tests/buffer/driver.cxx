@@ -0,0 +1,128 @@
+// file      : tests/buffer/driver.cxx
+// author    : Boris Kolpackov <boris@codesynthesis.com>
+// copyright : Copyright (c) 2009-2011 Code Synthesis Tools CC
+// license   : MIT; see accompanying LICENSE file
+
+// Test nul_scanner and length_prefix_scanner.
+//
+
+#include <string>
+#include <cassert>
+
+#include "test.hxx"
+
+using namespace std;
+
+// Append a length-prefixed argument.
+//
+static void
+add (string& b, const string& a)
+{
+  size_t n (a.size ());
+
+  b += static_cast<char> (n & 0xFF);
+  b += static_cast<char> ((n >> 8) & 0xFF);
+  b += static_cast<char> ((n >> 16) & 0xFF);
+  b += static_cast<char> ((n >> 24) & 0xFF);
+  b += a;
+  b += '\0';
+}
+
+int
+main ()
+{
+  // nul_scanner
+  //
+  {
+    cli::nul_scanner s ("", 0);
+    assert (!s.more ());
+  }
+
+  {
+    const string b ("-a\0-b\0hello world\0-c\0\0-c\0x\0rest\0", 32);
+    cli::nul_scanner s (b.c_str (), b.size ());
+    options o (s);
+
+    assert (o.a ());
+    assert (o.b () == "hello world");
+    assert (o.c ().size () == 2 && o.c ()[0] == "" && o.c ()[1] == "x");
+
+    assert (s.more ());
+    const char* r (s.next ());
+    assert (r == b.c_str () + 27 && string (r) == "rest");
+    assert (!s.more ());
+  }
+
+  {
+    const string b ("-a\0-b", 5);
+    cli::nul_scanner s (b.c_str (), b.size ());
+
+    assert (string (s.next ()) == "-a");
+
+    try
+    {
+      s.more ();
+      assert (false);
+    }
+    catch (const cli::invalid_buffer&)
+    {
+    }
+  }
+
+  // length_prefix_scanner
+  //
+  {
+    cli::length_prefix_scanner s ("", 0);
+    assert (!s.more ());
+  }
+
+  {
+    string b;
+    add (b, "-a");
+    add (b, "-b");
+    add (b, "hello world");
+    add (b, "-c");
+    add (b, "");
+    add (b, "x y");
+
+    cli::length_prefix_scanner s (b.c_str (), b.size ());
+    options o (s);
+
+    assert (o.a ());
+    assert (o.b () == "hello world");
+    assert (o.c ().size () == 1 && o.c ()[0] == "");
+
+    assert (s.more ());
+    const char* r (s.next ());
+    assert (string (r) == "x y" && s.size () == 3);
+    assert (!s.more ());
+  }
+
+  // Truncated size, value, missing terminator, and embedded NUL.
+  //
+  for (size_t i (0); i != 4; ++i)
+  {
+    string b;
+    add (b, "-a");
+
+    if (i == 0)
+      b += "\x01";
+    else if (i == 1)
+      add (b, "-b"), b.resize (b.size () - 2);
+    else if (i == 2)
+      add (b, "-b"), b[b.size () - 1] = 'x';
+    else
+      add (b, "-b"), add (b, string ("x\0y", 3));
+
+    cli::length_prefix_scanner s (b.c_str (), b.size ());
+
+    try
+    {
+      options o (s);
+      assert (false);
+    }
+    catch (const cli::invalid_buffer&)
+    {
+    }
+  }
+}
@@ -0,0 +1,136 @@
+// file      : tests/bundle/driver.cxx
+// author    : Boris Kolpackov <boris@codesynthesis.com>
+// copyright : Copyright (c) 2009-2011 Code Synthesis Tools CC
+// license   : MIT; see accompanying LICENSE file
+
+// Test bundling of single-character options.
+//
+
+#include <string>
+#include <cassert>
+
+#include "test.hxx"
+
+using namespace std;
+
+int
+main ()
+{
+  {
+    const char* argv[] = {"", "-vvv", "-xzf", "file", "-qj8", "arg"};
+    int argc (6);
+
+    options o (argc, const_cast<char**> (argv));
+
+    assert (o.verbose ().size () == 3);
+    assert (o.extract () && o.gzip () && o.quiet ());
+    assert (o.file () == "file");
+    assert (o.jobs () == 8);
+  }
+
+  // The rest of the bundle is the value. Long options and the -c names
+  // are still matched as whole arguments.
+  //
+  {
+    const char* argv[] = {"", "-fxz", "-j", "2", "--verbose", "-x"};
+    int argc (6);
+
+    options o (argc, const_cast<char**> (argv));
+
+    assert (o.file () == "xz" && !o.gzip ());
+    assert (o.jobs () == 2);
+    assert (o.verbose ().size () == 1 && o.extract ());
+  }
+
+  // Erase the bundle and its value.
+  //
+  {
+    const char* argv[] = {"", "-xf", "file", "arg", 0};
+    int argc (4);
+
+    options o (argc, const_cast<char**> (argv), true);
+
+    assert (o.extract () && o.file () == "file");
+    assert (argc == 2 && string (argv[1]) == "arg");
+  }
+
+  // A bundle with an unknown option is skipped as a whole and retained
+  // when erasing.
+  //
+  {
+    const char* argv[] = {"", "-xkz", "--bogus", "-z", "-fk", "arg", 0};
+    int argc (6);
+
+    options o (argc, const_cast<char**> (argv), true,
+               cli::unknown_mode::skip);
+
+    assert (!o.extract () && o.gzip () && o.file () == "k");
+    assert (argc == 4);
+    assert (string (argv[1]) == "-xkz" && string (argv[2]) == "--bogus");
+    assert (string (argv[3]) == "arg");
+  }
+
+  // Parsing stops at a bundle with an unknown option.
+  //
+  {
+    const char* argv[] = {"", "-z", "-xkz", "-f", "file", 0};
+    int argc (5);
+
+    options o (argc, const_cast<char**> (argv), true,
+               cli::unknown_mode::stop);
+
+    assert (o.gzip () && !o.extract () && o.file ().empty ());
+    assert (argc == 4);
+    assert (string (argv[1]) == "-xkz" && string (argv[2]) == "-f");
+  }
+
+  // Errors.
+  //
+  try
+  {
+    const char* argv[] = {"", "-kx"};
+    int argc (2);
+    options o (argc, const_cast<char**> (argv));
+    assert (false);
+  }
+  catch (const cli::unknown_option& e)
+  {
+    assert (e.option () == "-kx");
+  }
+
+  try
+  {
+    const char* argv[] = {"", "-xkz"};
+    int argc (2);
+    options o (argc, const_cast<char**> (argv));
+    assert (false);
+  }
+  catch (const cli::unknown_option& e)
+  {
+    assert (e.option () == "-xkz");
+  }
+
+  try
+  {
+    const char* argv[] = {"", "-xf"};
+    int argc (2);
+    options o (argc, const_cast<char**> (argv));
+    assert (false);
+  }
+  catch (const cli::missing_value& e)
+  {
+    assert (e.option () == "-f");
+  }
+
+  try
+  {
+    const char* argv[] = {"", "-jx"};
+    int argc (2);
+    options o (argc, const_cast<char**> (argv));
+    assert (false);
+  }
+  catch (const cli::invalid_value& e)
+  {
+    assert (e.option () == "-j" && e.value () == "x");
+  }
+}
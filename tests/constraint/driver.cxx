@@ -0,0 +1,121 @@
+// file      : tests/constraint/driver.cxx
+// author    : Boris Kolpackov <boris@codesynthesis.com>
+// copyright : Copyright (c) 2009-2011 Code Synthesis Tools CC
+// license   : MIT; see accompanying LICENSE file
+
+// Test required options and option groups.
+//
+
+#include <string>
+#include <cassert>
+
+#include "test.hxx"
+
+using namespace std;
+
+// Parse the arguments and return the error description or the empty
+// string if there were no errors.
+//
+static string
+parse (int argc, const char* argv[])
+{
+  try
+  {
+    options o (argc, const_cast<char**> (argv));
+    assert (!o.input ().empty ());
+  }
+  catch (const cli::missing_option& e)
+  {
+    return "missing " + e.option ();
+  }
+  catch (const cli::option_conflict& e)
+  {
+    return "conflict " + e.option () + " " + e.other ();
+  }
+
+  return "";
+}
+
+int
+main ()
+{
+  {
+    const char* a[] = {"", "-i", "in", "--xml", "--out", "out"};
+    assert (parse (6, a) == "");
+  }
+
+  {
+    const char* a[] = {"", "--xml", "--out", "out"};
+    assert (parse (4, a) == "missing --input");
+  }
+
+  {
+    const char* a[] = {"", "-i", "in", "--out", "out"};
+    assert (parse (5, a) == "missing --xml|--json");
+  }
+
+  {
+    const char* a[] = {"", "-i", "in", "--json", "--xml", "/o", "out"};
+    assert (parse (7, a) == "conflict --xml --json");
+  }
+
+  {
+    const char* a[] = {"", "-i", "in", "--xml"};
+    assert (parse (4, a) == "missing --out|/o");
+  }
+
+  {
+    const char* a[] = {"", "-i", "in", "--xml", "/o", "out", "--level", "1"};
+    assert (parse (8, a) == "missing --compress");
+  }
+
+  {
+    const char* a[] = {"", "-i", "in", "--xml", "/o", "out", "--level", "1",
+                       "--compress"};
+    assert (parse (9, a) == "");
+  }
+
+  // Constraints of the base class.
+  //
+  {
+    const char* a[] = {"", "-q", "-i", "in", "--xml", "/o", "out", "-v"};
+    assert (parse (8, a) == "conflict --verbose --quiet");
+  }
+
+  // The presence mask is cleared by reset().
+  //
+  {
+    const char* a[] = {"", "-i", "in", "--json", "/o", "out"};
+    int argc (6);
+    options o (argc, const_cast<char**> (a));
+
+    o.reset ();
+
+    const char* b[] = {"", "-i", "in", "--xml", "--out", "out"};
+    int argc2 (6);
+    cli::argv_scanner s (argc2, const_cast<char**> (b));
+    o.parse (s);
+    assert (o.xml () && !o.json ());
+  }
+
+  // Constraints of a base reachable through several paths.
+  //
+  {
+    const char* a[] = {"", "--fast", "--copy"};
+    int argc (3);
+    copy_options o (argc, const_cast<char**> (a));
+    assert (static_cast<const read_mode&> (o).fast () && o.copy ());
+  }
+
+  try
+  {
+    const char* a[] = {"", "--fast", "--safe"};
+    int argc (3);
+    copy_options o (argc, const_cast<char**> (a));
+    assert (false);
+  }
+  catch (const cli::option_conflict& e)
+  {
+    assert (e.option () == "--fast" && e.other () == "--safe");
+  }
+}
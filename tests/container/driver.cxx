@@ -0,0 +1,88 @@
+// file      : tests/container/driver.cxx
+// author    : Boris Kolpackov <boris@codesynthesis.com>
+// copyright : Copyright (c) 2009-2011 Code Synthesis Tools CC
+// license   : MIT; see accompanying LICENSE file
+
+// Test container option parsing.
+//
+
+#include <string>
+#include <cassert>
+
+#include "test.hxx"
+
+using namespace std;
+
+static options
+parse (int argc, const char* args[])
+{
+  return options (argc, const_cast<char**> (args));
+}
+
+static bool
+valid (const char* o, const char* v)
+{
+  const char* argv[] = {"driver", o, v, 0};
+
+  try
+  {
+    parse (3, argv);
+    return true;
+  }
+  catch (const cli::invalid_value& e)
+  {
+    assert (e.option () == o && e.value () == v);
+    return false;
+  }
+}
+
+int
+main ()
+{
+  {
+    const char* argv[] = {"driver",
+                          "-v", "a", "-v", "b c", "-v", "a",
+                          "-s", "2", "-s", "1", "-s", "2", 0};
+    options o (parse (13, argv));
+
+    assert (o.v ().size () == 3);
+    assert (o.v ()[0] == "a" && o.v ()[1] == "b c" && o.v ()[2] == "a");
+
+    assert (o.s ().size () == 2);
+    assert (*o.s ().begin () == 1 && *o.s ().rbegin () == 2);
+  }
+
+  {
+    const char* argv[] = {"driver",
+                          "-m", "a=1", "-m", "b=", "-m", "=3", "-m", "c",
+                          "-m", "a=5", 0};
+    options o (parse (11, argv));
+    const map<string, int>& m (o.m ());
+
+    assert (m.size () == 4);
+    assert (m.find ("a")->second == 5);
+    assert (m.find ("b")->second == 0);
+    assert (m.find ("c")->second == 0);
+    assert (m.find ("")->second == 3);
+  }
+
+  // Values are not tokenized and can contain '=' as well as spaces.
+  //
+  {
+    const char* argv[] = {"driver",
+                          "--ms", "1=a b", "--ms", "2==x", "--ms", "3", 0};
+    options o (parse (7, argv));
+    const map<int, string>& m (o.ms ());
+
+    assert (m.size () == 3);
+    assert (m.find (1)->second == "a b");
+    assert (m.find (2)->second == "=x");
+    assert (m.find (3)->second == "");
+  }
+
+  assert (!valid ("-s", "x"));
+  assert (!valid ("-m", "a=x"));
+  assert (!valid ("-m", "a=1x"));
+  assert (!valid ("--ms", "x=a"));
+  assert (!valid ("--ms", "1x"));
+}
@@ -0,0 +1,109 @@
+// file      : tests/cxx11/driver.cxx
+// author    : Boris Kolpackov <boris@codesynthesis.com>
+// copyright : Copyright (c) 2009-2011 Code Synthesis Tools CC
+// license   : MIT; see accompanying LICENSE file
+
+// Test the code generated in the C++11 mode: values moved into containers
+// and the parsing c-tors delegating to the default c-tor.
+//
+
+#include <string>
+#include <cassert>
+
+#include "test.hxx"
+
+using namespace std;
+
+// Check the values parsed from the arguments below.
+//
+static void
+check (const options& o)
+{
+  assert (o.flag () && o.level () == 2 && o.name () == "default");
+
+  assert (o.v ().size () == 3);
+  assert (o.v ()[0] == "a" && o.v ()[2] == "a");
+  assert (o.v ()[1] == "a rather long value that is not stored inline");
+
+  assert (o.s ().size () == 2);
+  assert (*o.s ().begin () == "x" && *o.s ().rbegin () == "y");
+
+  assert (o.m ().size () == 2);
+  assert (o.m ().find ("k")->second == "another rather long value");
+  assert (o.m ().find ("e")->second == "");
+}
+
+int
+main ()
+{
+  const char* args[] = {"driver", "--flag",
+                        "-v", "a",
+                        "-v", "a rather long value that is not stored inline",
+                        "-v", "a",
+                        "-s", "y", "-s", "x", "-s", "y",
+                        "-m", "k=v", "-m", "k=another rather long value",
+                        "-m", "e", "rest", 0};
+
+  const int n (static_cast<int> (sizeof (args) / sizeof (args[0])) - 1);
+  char** argv (const_cast<char**> (args));
+
+  // Defaults.
+  //
+  {
+    options o;
+    assert (!o.flag () && o.level () == 2 && o.name () == "default");
+    assert (o.v ().empty () && o.s ().empty () && o.m ().empty ());
+  }
+
+  // Each parsing c-tor initializes the defaults via the default c-tor.
+  //
+  {
+    int argc (n);
+    options o (argc, argv, false,
+               cli::unknown_mode::fail,
+               cli::unknown_mode::skip);
+    check (o);
+  }
+
+  {
+    int argc (n);
+    options o (1, argc, argv, false,
+               cli::unknown_mode::fail,
+               cli::unknown_mode::skip);
+    check (o);
+  }
+
+  {
+    int argc (n), end;
+    options o (argc, argv, end);
+    check (o);
+    assert (end == n - 1 && argv[end] == string ("rest"));
+  }
+
+  {
+    int argc (n), end;
+    options o (1, argc, argv, end);
+    check (o);
+    assert (end == n - 1);
+  }
+
+  {
+    int argc (n);
+    cli::argv_scanner s (argc, argv);
+    options o (s, cli::unknown_mode::fail, cli::unknown_mode::stop);
+    check (o);
+    assert (s.more () && s.next () == string ("rest"));
+  }
+
+  // Copies and moves retain the values.
+  //
+  {
+    int argc (n), end;
+    options o (argc, argv, end);
+    options c (o);
+    check (c);
+
+    options m (std::move (o));
+    check (m);
+  }
+}
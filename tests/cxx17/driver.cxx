@@ -0,0 +1,52 @@
+// file      : tests/cxx17/driver.cxx
+// author    : Boris Kolpackov <boris@codesynthesis.com>
+// copyright : Copyright (c) 2009-2011 Code Synthesis Tools CC
+// license   : MIT; see accompanying LICENSE file
+
+// Test the constexpr sorted option lookup.
+//
+
+#include <string>
+#include <cassert>
+
+#include "test.hxx"
+
+using namespace std;
+
+int
+main ()
+{
+  {
+    const char* argv[] = {"", "-i", "--a", "--ab", "--\xE9", "--\x7F",
+                          "-n", "foo", "--level", "2"};
+    int argc (static_cast<int> (sizeof (argv) / sizeof (argv[0])));
+
+    options o (argc, const_cast<char**> (argv));
+
+    assert (o.inherited () && o.a () && o.ab ());
+    assert (o.name () == "foo" && o.level () == 2);
+  }
+
+  // Names that are prefixes or extensions of existing names must not
+  // match.
+  //
+  {
+    const char* names[] = {"--", "--i", "--abc", "--\xE9\xE9", "-"};
+
+    for (size_t i (0); i < sizeof (names) / sizeof (names[0]); ++i)
+    {
+      const char* argv[] = {"", names[i]};
+      int argc (2);
+
+      try
+      {
+        options o (argc, const_cast<char**> (argv));
+        assert (names[i] == string ("--") || names[i] == string ("-"));
+      }
+      catch (const cli::unknown_option& e)
+      {
+        assert (e.option () == names[i]);
+      }
+    }
+  }
+}
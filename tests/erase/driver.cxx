@@ -32,4 +32,60 @@ main (int argc, char* argv[])
   assert (argv[4] == string ("--"));
   assert (argv[5] == string ("-b"));
   assert (argv[6] == string ("234"));
+
+  // Stopping at an unknown argument should leave the unparsed arguments
+  // in place.
+  //
+  {
+    char* av[] = {(char*) "driver", (char*) "-a", (char*) "foo",
+                  (char*) "-b", (char*) "1", (char*) "bar", (char*) "-a", 0};
+    int ac (7);
+
+    options o (ac, av, true,
+               cli::unknown_mode::skip,
+               cli::unknown_mode::stop);
+
+    assert (o.a () && o.b () == 0);
+    assert (ac == 6 && av[6] == 0);
+    assert (av[1] == string ("foo"));
+    assert (av[2] == string ("-b"));
+    assert (av[5] == string ("-a"));
+  }
+
+  // The unparsed arguments are in place after compact() while the
+  // scanner is still in use.
+  //
+  {
+    char* av[] = {(char*) "driver", (char*) "-a", (char*) "-b", (char*) "1",
+                  (char*) "foo", (char*) "-a", 0};
+    int ac (6);
+
+    cli::argv_scanner s (ac, av, true);
+    options o (s, cli::unknown_mode::stop, cli::unknown_mode::stop);
+
+    assert (o.a () && o.b () == 1);
+
+    s.compact ();
+    assert (ac == 3 && av[3] == 0);
+    assert (s.end () == 1 && av[s.end ()] == string ("foo"));
+    assert (av[2] == string ("-a"));
+
+    assert (s.more () && s.next () == string ("foo"));
+  }
+
+  // The same via the end argument.
+  //
+  {
+    char* av[] = {(char*) "driver", (char*) "-b", (char*) "2", (char*) "foo",
+                  (char*) "-a", 0};
+    int ac (5);
+    int end;
+
+    options o (ac, av, end, true,
+               cli::unknown_mode::stop,
+               cli::unknown_mode::stop);
+
+    assert (o.b () == 2 && !o.a ());
+    assert (ac == 3 && end == 1 && av[end] == string ("foo"));
+  }
 }
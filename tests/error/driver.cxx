@@ -0,0 +1,166 @@
+// file      : tests/error/driver.cxx
+// author    : Boris Kolpackov <boris@codesynthesis.com>
+// copyright : Copyright (c) 2009-2011 Code Synthesis Tools CC
+// license   : MIT; see accompanying LICENSE file
+
+// Test error reporting with --suppress-exceptions.
+//
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <cassert>
+
+#include "test.hxx"
+
+using namespace std;
+
+struct result
+{
+  options o;
+  cli::error e;
+  int end;
+};
+
+static result
+parse (const char* a1 = 0,
+       const char* a2 = 0,
+       const char* a3 = 0,
+       const char* a4 = 0,
+       cli::unknown_mode arg = cli::unknown_mode::fail)
+{
+  char* argv[] = {(char*) "driver",
+                  (char*) a1, (char*) a2, (char*) a3, (char*) a4, 0};
+  int argc (1);
+
+  for (; argc < 5 && argv[argc] != 0; ++argc) ;
+
+  cli::argv_file_scanner s (argc, argv, "--file");
+
+  result r;
+  r.o = options (s, cli::unknown_mode::fail, arg);
+  r.e = s.error ();
+  r.end = s.end ();
+  return r;
+}
+
+static string
+str (const cli::error& e)
+{
+  ostringstream os;
+  os << e;
+  return os.str ();
+}
+
+int
+main ()
+{
+  // No errors.
+  //
+  {
+    result r (parse ("-a", "-i", "123"));
+    assert (r.e.code () == cli::error::none);
+    assert (r.o.a () && r.o.i () == 123);
+  }
+
+  // Unknown option and argument.
+  //
+  {
+    result r (parse ("-a", "-x", "-i", "1"));
+    assert (r.e.code () == cli::error::unknown_option);
+    assert (r.e.option () == "-x");
+    assert (str (r.e) == "unknown option '-x'");
+    assert (r.o.a () && r.o.i () == 0);
+  }
+
+  {
+    result r (parse ("-a", "foo", "-i", "1"));
+    assert (r.e.code () == cli::error::unknown_argument);
+    assert (r.e.argument () == "foo");
+    assert (str (r.e) == "unknown argument 'foo'");
+  }
+
+  {
+    result r (parse ("-a", "foo", "-i", "1", cli::unknown_mode::stop));
+    assert (r.e.code () == cli::error::none);
+    assert (r.o.a () && r.o.i () == 0 && r.end == 2);
+  }
+
+  // Missing and invalid values, including inside containers.
+  //
+  {
+    result r (parse ("-a", "-i", "123", "-s"));
+    assert (r.e.code () == cli::error::missing_value);
+    assert (r.e.option () == "-s");
+    assert (str (r.e) == "missing value for option '-s'");
+  }
+
+  {
+    result r (parse ("-i", "12x", "-a"));
+    assert (r.e.code () == cli::error::invalid_value);
+    assert (r.e.option () == "-i" && r.e.value () == "12x");
+    assert (str (r.e) == "invalid value '12x' for option '-i'");
+    assert (!r.o.a ());
+  }
+
+  {
+    result r (parse ("-v", "1", "-v", "x"));
+    assert (r.e.code () == cli::error::invalid_value);
+    assert (r.o.v ().size () == 1 && r.o.v ()[0] == 1);
+  }
+
+  {
+    result r (parse ("-m", "a=1", "-m", "b=x"));
+    assert (r.e.code () == cli::error::invalid_value);
+    assert (r.e.value () == "b=x");
+    assert (r.o.m ().size () == 1 && r.o.m ().find ("a")->second == 1);
+  }
+
+  // Options file errors.
+  //
+  {
+    result r (parse ("--file"));
+    assert (r.e.code () == cli::error::missing_value);
+    assert (r.e.option () == "--file");
+  }
+
+  {
+    result r (parse ("-a", "--file", "no-such-file.ops", "-i"));
+    assert (r.e.code () == cli::error::file_io_failure);
+    assert (r.e.file () == "no-such-file.ops");
+    assert (str (r.e) ==
+            "unable to open file 'no-such-file.ops' or read failure");
+    assert (r.o.a () && r.o.i () == 0);
+  }
+
+  {
+    {
+      ofstream ofs ("test.ops");
+      ofs << "-s 'foo" << endl;
+    }
+
+    result r (parse ("--file", "test.ops", "-a"));
+    assert (r.e.code () == cli::error::unmatched_quote);
+    assert (r.e.argument () == "'foo");
+    assert (str (r.e) == "unmatched quote in argument ''foo'");
+    assert (!r.o.a () && r.o.s ().empty ());
+  }
+
+  // Scanner functions past the end of the stream.
+  //
+  {
+    char* argv[] = {(char*) "driver", 0};
+    int argc (1);
+    cli::argv_scanner s (argc, argv);
+
+    assert (!s.more ());
+    assert (s.peek () == 0);
+    assert (s.error ().code () == cli::error::eos_reached);
+    assert (str (s.error ()) == "end of argument stream reached");
+
+    // The first error is preserved.
+    //
+    s.fail (cli::error (cli::error::unknown_option, "-x"));
+    assert (s.error ().code () == cli::error::eos_reached);
+  }
+}
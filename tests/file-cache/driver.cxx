@@ -0,0 +1,111 @@
+// file      : tests/file-cache/driver.cxx
+// author    : Boris Kolpackov <boris@codesynthesis.com>
+// copyright : Copyright (c) 2009-2011 Code Synthesis Tools CC
+// license   : MIT; see accompanying LICENSE file
+
+// Test argv_file_scanner options file caching.
+//
+
+#include <string>
+#include <vector>
+#include <cassert>
+#include <cstdio>  // std::remove
+#include <fstream>
+
+#include "test.hxx"
+
+using namespace std;
+
+static void
+write (const char* file, const char* content)
+{
+  ofstream ofs (file, ios_base::out | ios_base::binary);
+  ofs << content;
+}
+
+static bool
+exists (const char* file)
+{
+  ifstream ifs (file);
+  return ifs.is_open ();
+}
+
+static string
+search (const char* v, void*)
+{
+  // Resolve the name at runtime so that cached results are not affected.
+  //
+  return string (v) + ".ops";
+}
+
+static string
+scan (bool cache)
+{
+  char* argv[] = {(char*) "driver", (char*) "x",
+                  (char*) "--file", (char*) "test-a.ops", (char*) "y"};
+  int argc (5);
+
+  cli::argv_file_scanner::option_info oi[2];
+  oi[0].option = "--file";
+  oi[0].search_func = 0;
+  oi[1].option = "--include";
+  oi[1].search_func = &search;
+
+  cli::argv_file_scanner s (argc, argv, oi, 2);
+
+  if (cache)
+    s.cache ("");
+
+  string r;
+  while (s.more ())
+  {
+    r += s.next ();
+    r += '|';
+  }
+
+  return r;
+}
+
+int
+main ()
+{
+  remove ("test-a.ops.cli-cache");
+  remove ("test-b.ops.cli-cache");
+
+  write ("test-a.ops",
+         "# comment\n"
+         "-a 1\n"
+         "--include test-b\n"
+         "-c  ' x '\n"
+         "-d \"\"\n"
+         "--\n"
+         "--file test-b.ops\n");
+  write ("test-b.ops", "-b  2 \r\n\n");
+
+  string e ("x|-a|1|-b|2|-c| x |-d||--|--file|test-b.ops|y|");
+
+  assert (scan (false) == e);
+  assert (!exists ("test-a.ops.cli-cache"));
+
+  // First run creates the cache files and the second uses them.
+  //
+  assert (scan (true) == e);
+  assert (exists ("test-a.ops.cli-cache"));
+  assert (exists ("test-b.ops.cli-cache"));
+  assert (scan (true) == e);
+
+  // A change in the options file size invalidates the cache.
+  //
+  write ("test-b.ops", "-b 3\n-e 4\n");
+  assert (scan (true) == "x|-a|1|-b|3|-e|4|-c| x |-d||--|--file|test-b.ops|y|");
+
+  // A corrupt cache file is ignored.
+  //
+  write ("test-b.ops.cli-cache", "garbage");
+  assert (scan (true) == "x|-a|1|-b|3|-e|4|-c| x |-d||--|--file|test-b.ops|y|");
+
+  remove ("test-a.ops");
+  remove ("test-b.ops");
+  remove ("test-a.ops.cli-cache");
+  remove ("test-b.ops.cli-cache");
+}
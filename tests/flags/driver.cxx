@@ -0,0 +1,64 @@
+// file      : tests/flags/driver.cxx
+// author    : Boris Kolpackov <boris@codesynthesis.com>
+// copyright : Copyright (c) 2009-2011 Code Synthesis Tools CC
+// license   : MIT; see accompanying LICENSE file
+
+// Test packed bool options and specifier flags.
+//
+
+#include <string>
+#include <cassert>
+
+#include "test.hxx"
+
+using namespace std;
+
+int
+main ()
+{
+  const char* argv[] = {"", "-a", "-c", "foo", "-v", "--flags", "bar"};
+  int argc (static_cast<int> (sizeof (argv) / sizeof (argv[0])));
+
+  options o;
+  cli::argv_scanner s (argc, const_cast<char**> (argv));
+  o.parse (s);
+
+  assert (o.a () && o.b () && o.flags ());
+  assert (o.c () == "foo" && o.c_specified ());
+  assert (o.verbose () && o.level () == 1 && !o.level_specified ());
+  assert (string (s.next ()) == "bar");
+
+  // Mask queries.
+  //
+  cli::flag_set<4> m;
+  m.set (options::a_bit).set (options::c_specified_bit);
+  assert (o.flags1 ().all (m));
+
+  cli::flag_set<2> bm;
+  bm.set (base::level_specified_bit);
+  assert (!o.base::flags ().any (bm));
+  bm.set (base::verbose_bit);
+  assert (o.base::flags ().any (bm) && !o.base::flags ().all (bm));
+
+  // Modifiers.
+  //
+  o.a () = false;
+  o.b (false);
+  o.level_specified (true);
+  assert (!o.a () && !o.b () && o.level_specified ());
+  assert (!o.flags1 ().all (m) && o.base::flags ().all (bm));
+
+  // Copies and comparisons.
+  //
+  options c (o);
+  assert (c.flags1 () == o.flags1 ());
+  c.a () = o.c_specified ();
+  assert (c.a () && c.flags1 () != o.flags1 ());
+
+  // The initializers are restored by reset().
+  //
+  o.reset ();
+  assert (!o.a () && o.b () && !o.flags () && !o.c_specified ());
+  assert (!o.verbose () && !o.level_specified ());
+  assert (o.flags1 () == options ().flags1 ());
+}
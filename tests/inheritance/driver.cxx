@@ -33,4 +33,22 @@ main (int argc, char* argv[])
   assert (o.string () == "long");
 
   options::print_usage (cout);
+
+  // The options of the top class reached through several paths are set
+  // in the subobject of the first path (west).
+  //
+  {
+    const char* av[] = {"", "--flag", "--level", "2", "--east-flag",
+                        "--bottom-flag"};
+    int ac (6);
+
+    bottom b (ac, const_cast<char**> (av));
+
+    const west& w (b);
+    const east& e (b);
+
+    assert (w.flag () && w.level () == 2);
+    assert (!e.flag () && e.level () == 1);
+    assert (!b.west_flag () && b.east_flag () && b.bottom_flag ());
+  }
 }
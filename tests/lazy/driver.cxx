@@ -0,0 +1,73 @@
+// file      : tests/lazy/driver.cxx
+// author    : Boris Kolpackov <boris@codesynthesis.com>
+// copyright : Copyright (c) 2009-2011 Code Synthesis Tools CC
+// license   : MIT; see accompanying LICENSE file
+
+// Test lazy default value computation.
+//
+
+#include <string>
+#include <cassert>
+
+#include "test.hxx"
+
+using namespace std;
+
+int
+main ()
+{
+  // Nothing is computed by the c-tor.
+  //
+  {
+    options o;
+    assert (calls () == 0);
+
+    // The default is computed once, on the first read.
+    //
+    assert (o.jobs () == 4 && o.jobs () == 4);
+    assert (calls () == 1);
+
+    // Copies retain the computed value.
+    //
+    options c (o);
+    assert (c.jobs () == 4 && calls () == 1);
+
+    // Multi-word type names are handled.
+    //
+    assert (o.limit () == 16);
+  }
+
+  // Specified options are never computed.
+  //
+  {
+    calls () = 0;
+
+    const char* argv[] = {"", "-j", "8", "--name", "foo", "--level", "2"};
+    int argc (static_cast<int> (sizeof (argv) / sizeof (argv[0])));
+
+    options o (argc, const_cast<char**> (argv));
+    assert (o.jobs () == 8 && o.name () == "foo" && o.level () == 2);
+    assert (calls () == 0);
+
+    assert (o.color () && calls () == 1);
+
+    // The default is computed again after reset().
+    //
+    o.reset ();
+    assert (calls () == 1);
+    assert (o.jobs () == 4 && o.name () == "lazy" && calls () == 3);
+  }
+
+  // Modifiers.
+  //
+  {
+    calls () = 0;
+
+    options o;
+    o.jobs (2);
+    assert (o.jobs () == 2 && calls () == 0);
+
+    o.name () += "-x";
+    assert (o.name () == "lazy-x" && calls () == 1);
+  }
+}
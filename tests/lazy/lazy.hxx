@@ -0,0 +1,41 @@
+// file      : tests/lazy/lazy.hxx
+// author    : Boris Kolpackov <boris@codesynthesis.com>
+// copyright : Copyright (c) 2009-2011 Code Synthesis Tools CC
+// license   : MIT; see accompanying LICENSE file
+
+#ifndef LAZY_HXX
+#define LAZY_HXX
+
+#include <string>
+
+// Default value functions that count how many times they are called.
+//
+inline int&
+calls ()
+{
+  static int n;
+  return n;
+}
+
+inline int
+default_jobs ()
+{
+  ++calls ();
+  return 4;
+}
+
+inline std::string
+default_name ()
+{
+  ++calls ();
+  return "lazy";
+}
+
+inline bool
+default_color ()
+{
+  ++calls ();
+  return true;
+}
+
+#endif // LAZY_HXX
@@ -0,0 +1,94 @@
+// file      : tests/lookup/driver.cxx
+// author    : Boris Kolpackov <boris@codesynthesis.com>
+// copyright : Copyright (c) 2009-2011 Code Synthesis Tools CC
+// license   : MIT; see accompanying LICENSE file
+
+// Test perfect hash option lookup.
+//
+
+#include <string>
+#include <cassert>
+
+#include "test.hxx"
+
+using namespace std;
+
+int
+main ()
+{
+  // All the option names, including the inherited ones.
+  //
+  {
+    char* argv[] = {
+      (char*) "driver", (char*) "-?", (char*) "-v", (char*) "-l", (char*) "3",
+      (char*) "--output", (char*) "out", (char*) "--xx", (char*) "-b",
+      (char*) "--base-name", (char*) "derived", (char*) "--tab\tname",
+      (char*) "arg"};
+    int argc (sizeof (argv) / sizeof (char*));
+
+    options o (argc, argv, true);
+
+    assert (o.help () && o.version ());
+    assert (o.level () == 3 && o.output () == "out");
+    assert (!o.x () && o.xx () && !o.xxx ());
+    assert (o.base_flag () && o.base_name () == "derived");
+    assert (o.tab_tname ());
+    assert (argc == 2 && argv[1] == string ("arg"));
+  }
+
+  // Names that are prefixes or extensions of existing names as well
+  // as names that hash into empty slots must not match.
+  //
+  {
+    const char* names[] = {"--", "--x-", "--xxxx", "--he", "--helpx",
+                           "--tab", "--tab name", "-vv"};
+
+    for (size_t i (0); i < sizeof (names) / sizeof (char*); ++i)
+    {
+      char* argv[] = {(char*) "driver", (char*) names[i]};
+      int argc (2);
+
+      try
+      {
+        options o (argc, argv);
+        assert (names[i] == string ("--")); // Option separator.
+      }
+      catch (const cli::unknown_option& e)
+      {
+        assert (e.option () == names[i]);
+      }
+    }
+  }
+
+  // Options from the whole hierarchy, including the same names in
+  // several classes.
+  //
+  {
+    char* argv[] = {
+      (char*) "driver", (char*) "-t", (char*) "--name", (char*) "n",
+      (char*) "--path", (char*) "p", (char*) "-b", (char*) "--verbose"};
+    int argc (sizeof (argv) / sizeof (char*));
+
+    command o (argc, argv);
+
+    assert (o.command::t () && !o.logging::t ());
+    assert (o.store::name () == "n" && o.logging::name () == "logging");
+    assert (o.path () == "p" && o.base_flag () && o.verbose ());
+  }
+
+  // Class without options.
+  //
+  {
+    char* argv[] = {(char*) "driver", (char*) "--foo"};
+    int argc (2);
+
+    try
+    {
+      no_options o (argc, argv);
+      assert (false);
+    }
+    catch (const cli::unknown_option&)
+    {
+    }
+  }
+}
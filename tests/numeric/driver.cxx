@@ -0,0 +1,136 @@
+// file      : tests/numeric/driver.cxx
+// author    : Boris Kolpackov <boris@codesynthesis.com>
+// copyright : Copyright (c) 2009-2011 Code Synthesis Tools CC
+// license   : MIT; see accompanying LICENSE file
+
+// Test numeric value parsers.
+//
+
+#include <string>
+#include <cassert>
+#include <climits>
+#include <cstdio>  // std::sprintf
+
+#include "test.hxx"
+
+using namespace std;
+
+static bool
+valid (const char* o, const char* v)
+{
+  char* argv[] = {(char*) "driver", (char*) o, (char*) v};
+  int argc (3);
+
+  try
+  {
+    options x (argc, argv);
+    return true;
+  }
+  catch (const cli::invalid_value& e)
+  {
+    assert (e.option () == o && e.value () == v);
+    return false;
+  }
+}
+
+static options
+parse (const char* o, const char* v)
+{
+  char* argv[] = {(char*) "driver", (char*) o, (char*) v};
+  int argc (3);
+
+  return options (argc, argv);
+}
+
+int
+main ()
+{
+  char b[64];
+
+  // Integers.
+  //
+  assert (parse ("-i", "123").i () == 123);
+  assert (parse ("-i", "+123").i () == 123);
+  assert (parse ("-i", "-123").i () == -123);
+  assert (parse ("-i", "-0").i () == 0);
+
+  sprintf (b, "%d", INT_MAX);
+  assert (parse ("-i", b).i () == INT_MAX);
+  sprintf (b, "%d", INT_MIN);
+  assert (parse ("-i", b).i () == INT_MIN);
+  sprintf (b, "%ld", LONG_MIN);
+  assert (parse ("-l", b).l () == LONG_MIN);
+  sprintf (b, "%lu", ULONG_MAX);
+  assert (parse ("--ul", b).ul () == ULONG_MAX);
+
+  assert (parse ("-s", "-32768").s () == -32768);
+  assert (!valid ("-s", "32768"));
+  assert (!valid ("-s", "-32769"));
+  assert (parse ("--us", "65535").us () == 65535);
+  assert (!valid ("--us", "65536"));
+
+  sprintf (b, "%lu0", ULONG_MAX);
+  assert (!valid ("--ul", b));
+  assert (!valid ("-l", b));
+  assert (!valid ("--ui", "-1"));
+
+  assert (!valid ("-i", ""));
+  assert (!valid ("-i", "-"));
+  assert (!valid ("-i", "+-1"));
+  assert (!valid ("-i", "1x"));
+  assert (!valid ("-i", " 1"));
+  assert (!valid ("-i", "0x10"));
+
+  // Floating point.
+  //
+  assert (parse ("-d", "1.5").d () == 1.5);
+  assert (parse ("-d", "-.5").d () == -0.5);
+  assert (parse ("-d", "5.").d () == 5.0);
+  assert (parse ("-d", "1e3").d () == 1000.0);
+  assert (parse ("-d", "+2.5E-1").d () == 0.25);
+  assert (parse ("-f", "0.25").f () == 0.25f);
+
+  assert (!valid ("-f", "1e39"));
+  assert (!valid ("-d", "1e309"));
+  assert (!valid ("-d", "."));
+  assert (!valid ("-d", "1e"));
+  assert (!valid ("-d", "1.5x"));
+  assert (!valid ("-d", "inf"));
+  assert (!valid ("-d", "nan"));
+  assert (!valid ("-d", "0x1p3"));
+
+  // Characters.
+  //
+  assert (parse ("-c", "a").c () == 'a');
+  assert (parse ("--uc", "z").uc () == 'z');
+  assert (!valid ("--sc", ""));
+  assert (!valid ("--sc", "ab"));
+
+  // Containers use the specializations for their elements.
+  //
+  {
+    char* argv[] = {(char*) "driver", (char*) "-v", (char*) "1",
+                    (char*) "-v", (char*) "-2"};
+    int argc (5);
+
+    options o (argc, argv);
+    assert (o.v ().size () == 2 && o.v ()[0] == 1 && o.v ()[1] == -2);
+  }
+
+  // Missing value.
+  //
+  {
+    char* argv[] = {(char*) "driver", (char*) "-i"};
+    int argc (2);
+
+    try
+    {
+      options o (argc, argv);
+      assert (false);
+    }
+    catch (const cli::missing_value& e)
+    {
+      assert (e.option () == "-i");
+    }
+  }
+}
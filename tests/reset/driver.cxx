@@ -0,0 +1,77 @@
+// file      : tests/reset/driver.cxx
+// author    : Boris Kolpackov <boris@codesynthesis.com>
+// copyright : Copyright (c) 2009-2011 Code Synthesis Tools CC
+// license   : MIT; see accompanying LICENSE file
+
+// Test reusing an options object with reset() and parse().
+//
+
+#include <string>
+#include <cassert>
+
+#include "test.hxx"
+
+using namespace std;
+
+static void
+parse (options& o, int argc, const char* args[])
+{
+  cli::argv_scanner s (argc, const_cast<char**> (args));
+  o.parse (s);
+}
+
+static void
+check_defaults (const options& o)
+{
+  assert (!o.flag () && o.level () == 3 && !o.level_specified ());
+  assert (o.mask () == 6 && !o.mask_specified ());
+  assert (o.name () == "default" && !o.name_specified ());
+  assert (o.output ().empty () && !o.output_specified ());
+  assert (o.I ().empty () && !o.I_specified ());
+  assert (o.values ().size () == 2 && o.values ()[1] == 7);
+  assert (o.D ().empty () && !o.D_specified ());
+}
+
+int
+main ()
+{
+  options o;
+  check_defaults (o);
+
+  const char* a1[] = {"driver", "--flag", "--level", "5", "--mask", "1",
+                      "--name", "first", "--output", "a-rather-long-output-name",
+                      "-I", "a", "-I", "b", "-I", "c",
+                      "--values", "1", "-D", "k=v"};
+  parse (o, 20, a1);
+
+  assert (o.flag () && o.level () == 5 && o.mask () == 1);
+  assert (o.name () == "first" && o.output_specified ());
+  assert (o.I ().size () == 3 && o.values ().size () == 3);
+  assert (o.D ().size () == 1);
+
+  string::size_type oc (o.output ().capacity ());
+  vector<string>::size_type ic (o.I ().capacity ());
+
+  o.reset ();
+  check_defaults (o);
+
+  // The memory allocated by the values is retained.
+  //
+  assert (o.output ().capacity () == oc);
+  assert (o.I ().capacity () == ic);
+
+  const char* a2[] = {"driver", "-I", "x", "--level", "1"};
+  parse (o, 5, a2);
+
+  assert (!o.flag () && o.level () == 1);
+  assert (o.name () == "default" && o.output ().empty ());
+  assert (o.I ().size () == 1 && o.I ()[0] == "x");
+
+  // Without reset() the values accumulate.
+  //
+  const char* a3[] = {"driver", "-I", "y"};
+  parse (o, 3, a3);
+
+  assert (o.level () == 1);
+  assert (o.I ().size () == 2 && o.I ()[1] == "y");
+}
@@ -0,0 +1,86 @@
+// file      : tests/sink/driver.cxx
+// author    : Boris Kolpackov <boris@codesynthesis.com>
+// copyright : Copyright (c) 2009-2011 Code Synthesis Tools CC
+// license   : MIT; see accompanying LICENSE file
+
+// Test sink options.
+//
+
+#include <string>
+#include <vector>
+#include <cassert>
+
+#include "test.hxx"
+
+using namespace std;
+
+static void
+input (const string& v, void* arg)
+{
+  static_cast<vector<string>*> (arg)->push_back (v);
+}
+
+static void
+sum (const int& v, void* arg)
+{
+  *static_cast<int*> (arg) += v;
+}
+
+int
+main ()
+{
+  {
+    const char* argv[] = {"", "-i", "a", "-n", "1", "--input", "b",
+                          "-a", "-n", "2", "-i", "", "c"};
+    int argc (static_cast<int> (sizeof (argv) / sizeof (argv[0])));
+
+    vector<string> in;
+    int n (0);
+
+    options o;
+    o.input (&input, &in);
+    o.n (&sum, &n);
+
+    cli::argv_scanner s (argc, const_cast<char**> (argv));
+    o.parse (s);
+
+    assert (o.a ());
+    assert (o.input_specified () && o.n_specified ());
+    assert (in.size () == 3 && in[0] == "a" && in[1] == "b" && in[2] == "");
+    assert (n == 3);
+    assert (string (s.next ()) == "c");
+
+    // The sink functions are retained by reset().
+    //
+    o.reset ();
+    assert (!o.input_specified () && !o.n_specified ());
+
+    const char* argv2[] = {"", "-i", "d"};
+    int argc2 (3);
+    cli::argv_scanner s2 (argc2, const_cast<char**> (argv2));
+    o.parse (s2);
+
+    assert (o.input_specified () && !o.n_specified ());
+    assert (in.size () == 4 && in[3] == "d");
+  }
+
+  // Without a sink function the values are discarded but still validated.
+  //
+  {
+    const char* argv[] = {"", "-n", "x"};
+    int argc (3);
+
+    options o;
+    cli::argv_scanner s (argc, const_cast<char**> (argv));
+
+    try
+    {
+      o.parse (s);
+      assert (false);
+    }
+    catch (const cli::invalid_value& e)
+    {
+      assert (e.option () == "-n" && e.value () == "x");
+    }
+  }
+}
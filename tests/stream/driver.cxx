@@ -0,0 +1,104 @@
+// file      : tests/stream/driver.cxx
+// author    : Boris Kolpackov <boris@codesynthesis.com>
+// copyright : Copyright (c) 2009-2011 Code Synthesis Tools CC
+// license   : MIT; see accompanying LICENSE file
+
+// Test stream_scanner.
+//
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <cassert>
+
+#include "test.hxx"
+
+using namespace std;
+
+static vector<string>
+scan (const string& s, char d = '\n', size_t n = 65536)
+{
+  istringstream is (s);
+  cli::stream_scanner sc (is, d, n);
+  vector<string> r;
+
+  while (sc.more ())
+    r.push_back (sc.next ());
+
+  return r;
+}
+
+int
+main ()
+{
+  // Try various chunk sizes, including those smaller than the arguments.
+  //
+  for (size_t n (1); n != 10; ++n)
+  {
+    assert (scan ("", '\n', n).empty ());
+
+    {
+      vector<string> r (scan ("-a\r\n-b\n\nlast", '\n', n));
+      assert (r.size () == 4);
+      assert (r[0] == "-a" && r[1] == "-b" && r[2] == "" && r[3] == "last");
+    }
+
+    {
+      vector<string> r (scan (string ("x y\0\0z\n\0", 8), '\0', n));
+      assert (r.size () == 3);
+      assert (r[0] == "x y" && r[1] == "" && r[2] == "z\n");
+    }
+
+    {
+      istringstream is ("-a\n-b\nhello world\n-c\n123\n-d\nk=v\nrest\n");
+      cli::stream_scanner s (is, '\n', n);
+      options o (s);
+
+      assert (o.a ());
+      assert (o.b () == "hello world");
+      assert (o.c () == 123);
+      assert (o.d ().size () == 1 && o.d ().find ("k")->second == "v");
+      assert (s.more () && string (s.next ()) == "rest");
+      assert (!s.more ());
+    }
+
+    // The option name remains valid when reporting an error.
+    //
+    {
+      istringstream is ("-c\nabc\n");
+      cli::stream_scanner s (is, '\n', n);
+
+      try
+      {
+        options o (s);
+        assert (false);
+      }
+      catch (const cli::invalid_value& e)
+      {
+        assert (e.option () == "-c" && e.value () == "abc");
+      }
+    }
+  }
+
+  // Many arguments.
+  //
+  {
+    ostringstream os;
+
+    for (size_t i (0); i != 100000; ++i)
+      os << "file-" << i << '\n';
+
+    istringstream is (os.str ());
+    cli::stream_scanner s (is, '\n', 4096);
+
+    size_t i (0);
+    for (; s.more (); ++i)
+    {
+      ostringstream f;
+      f << "file-" << i;
+      assert (s.next () == f.str ());
+    }
+
+    assert (i == 100000);
+  }
+}
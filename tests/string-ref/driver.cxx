@@ -0,0 +1,64 @@
+// file      : tests/string-ref/driver.cxx
+// author    : Boris Kolpackov <boris@codesynthesis.com>
+// copyright : Copyright (c) 2009-2011 Code Synthesis Tools CC
+// license   : MIT; see accompanying LICENSE file
+
+// Test the string_ref option type.
+//
+
+#include <string>
+#include <cassert>
+#include <sstream>
+
+#include "test.hxx"
+
+using namespace std;
+
+int
+main (int argc, char* argv[])
+{
+  // Values from argv are referenced in place.
+  //
+  {
+    char* av[] = {(char*) "driver", (char*) "-a", (char*) "foo"};
+    int ac (3);
+
+    options o (ac, av);
+
+    assert (o.a ().data () == av[2]);
+    assert (o.a () == "foo" && o.a ().size () == 3);
+    assert (o.d () == cli::string_ref ("default"));
+  }
+
+  // Values from options files remain valid for the lifetime of the
+  // scanner.
+  //
+  {
+    cli::argv_file_scanner s (argc, argv, "--file");
+    options o (s);
+
+    assert (o.a () == "foo");
+    assert (o.b ().size () == 3);
+    assert (o.b ()[0] == "x" && o.b ()[1] == "y" && o.b ()[2] == "z");
+
+    assert (o.c ().size () == 2);
+    assert (*o.c ().begin () == "baz");
+    assert (o.c ().begin ()->str () == "baz");
+    assert (*o.c ().rbegin () == string ("foo bar"));
+
+    ostringstream os;
+    os << o.b ()[1];
+    assert (os.str () == "y");
+  }
+
+  // Comparison.
+  //
+  {
+    cli::string_ref e, a ("ab"), b ("abc", 2), c ("abc");
+
+    assert (e.empty () && e == "");
+    assert (a == b && !(a != b));
+    assert (a < c && !(c < a) && !(a < b));
+    assert (string (c.begin (), c.end ()) == "abc");
+  }
+}
@@ -0,0 +1,124 @@
+// file      : tests/string/driver.cxx
+// author    : Boris Kolpackov <boris@codesynthesis.com>
+// copyright : Copyright (c) 2009-2011 Code Synthesis Tools CC
+// license   : MIT; see accompanying LICENSE file
+
+// Test string_scanner.
+//
+
+#include <string>
+#include <vector>
+#include <cassert>
+
+#include "test.hxx"
+
+using namespace std;
+
+static vector<string>
+scan (const string& s)
+{
+  vector<char> b (s.begin (), s.end ());
+  b.push_back ('\0');
+
+  cli::string_scanner sc (&b[0]);
+  vector<string> r;
+
+  while (sc.more ())
+  {
+    const char* a (sc.next ());
+
+    // Arguments point into the buffer.
+    //
+    assert (a >= &b[0] && a < &b[0] + b.size ());
+    r.push_back (a);
+  }
+
+  return r;
+}
+
+static bool
+unmatched (const string& s)
+{
+  vector<char> b (s.begin (), s.end ());
+  b.push_back ('\0');
+
+  cli::string_scanner sc (&b[0]);
+
+  try
+  {
+    while (sc.more ())
+      sc.next ();
+  }
+  catch (const cli::unmatched_quote&)
+  {
+    return true;
+  }
+
+  return false;
+}
+
+int
+main ()
+{
+  assert (scan ("").empty ());
+  assert (scan (" \t\r\n ").empty ());
+
+  {
+    vector<string> r (scan ("  -a\t-b  foo\n-c bar "));
+    assert (r.size () == 5);
+    assert (r[0] == "-a" && r[1] == "-b" && r[2] == "foo");
+    assert (r[3] == "-c" && r[4] == "bar");
+  }
+
+  {
+    vector<string> r (scan ("-b \"foo bar\" -c ' baz ' \"\" x"));
+    assert (r.size () == 6);
+    assert (r[1] == "foo bar");
+    assert (r[3] == " baz ");
+    assert (r[4] == "");
+    assert (r[5] == "x");
+  }
+
+  // A quote that is not followed by a whitespace does not close.
+  //
+  {
+    vector<string> r (scan ("\"a\"b c\" d"));
+    assert (r.size () == 2);
+    assert (r[0] == "a\"b c");
+    assert (r[1] == "d");
+  }
+
+  assert (unmatched ("-b \"foo"));
+  assert (unmatched ("-b \""));
+  assert (unmatched ("-b foo'"));
+  assert (!unmatched ("-b fo'o"));
+
+  // Parse.
+  //
+  {
+    char s[] = "-a -b 'hello world' -c x -c \"y z\" rest";
+    cli::string_scanner sc (s);
+    options o (sc);
+
+    assert (o.a ());
+    assert (o.b () == "hello world");
+    assert (o.c ().size () == 2 && o.c ()[0] == "x" && o.c ()[1] == "y z");
+    assert (sc.more () && string (sc.next ()) == "rest");
+    assert (!sc.more ());
+  }
+
+  {
+    char s[] = "-b";
+    cli::string_scanner sc (s);
+
+    try
+    {
+      options o (sc);
+      assert (false);
+    }
+    catch (const cli::missing_value& e)
+    {
+      assert (e.option () == "-b");
+    }
+  }
+}
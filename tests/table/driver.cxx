@@ -0,0 +1,77 @@
+// file      : tests/table/driver.cxx
+// author    : Boris Kolpackov <boris@codesynthesis.com>
+// copyright : Copyright (c) 2009-2011 Code Synthesis Tools CC
+// license   : MIT; see accompanying LICENSE file
+
+// Test the table-driven parsing backend.
+//
+
+#include <string>
+#include <cassert>
+
+#include "test.hxx"
+
+using namespace std;
+
+int
+main ()
+{
+  {
+    const char* argv[] = {"", "-v", "--level", "2", "--name", "foo",
+                          "--uint", "3", "--long", "-4", "--ulong", "5",
+                          "--double", "6.5", "--vector", "a", "--vector", "b",
+                          "--small", "7", "--map", "k=8", "-j", "9"};
+    int argc (static_cast<int> (sizeof (argv) / sizeof (argv[0])));
+
+    options o (argc, const_cast<char**> (argv));
+
+    assert (o.verbose () && o.level () == 2);
+    assert (!o.help ());
+    assert (o.name () == "foo" && o.name_specified ());
+    assert (o.uint () == 3 && o.uint_specified ());
+    assert (o.long_ () == -4 && o.ulong () == 5 && o.double_ () == 6.5);
+    assert (o.vector ().size () == 2 && o.vector ()[1] == "b");
+    assert (o.small () == 7 && o.small_specified ());
+    assert (o.map ().find ("k")->second == 8);
+    assert (o.jobs () == 9);
+  }
+
+  {
+    const char* argv[] = {"", "-h"};
+    int argc (2);
+
+    options o (argc, const_cast<char**> (argv));
+    assert (o.help () && !o.verbose () && o.level () == 1);
+    assert (o.name () == "none" && !o.name_specified ());
+    assert (!o.uint_specified () && o.jobs () == 4);
+  }
+
+  // Errors.
+  //
+  try
+  {
+    const char* argv[] = {"", "--uint", "x"};
+    int argc (3);
+    options o (argc, const_cast<char**> (argv));
+    assert (false);
+  }
+  catch (const cli::invalid_value&) {}
+
+  try
+  {
+    const char* argv[] = {"", "--small"};
+    int argc (2);
+    options o (argc, const_cast<char**> (argv));
+    assert (false);
+  }
+  catch (const cli::missing_value&) {}
+
+  try
+  {
+    const char* argv[] = {"", "-h", "--uint", "1"};
+    int argc (4);
+    options o (argc, const_cast<char**> (argv));
+    assert (false);
+  }
+  catch (const cli::option_conflict&) {}
+}
@@ -0,0 +1,191 @@
+// file      : tests/threads/driver.cxx
+// author    : Boris Kolpackov <boris@codesynthesis.com>
+// copyright : Copyright (c) 2009-2011 Code Synthesis Tools CC
+// license   : MIT; see accompanying LICENSE file
+
+// Test concurrent parsing, including the first use of the lookup table
+// and option description, as well as concurrent reads of a shared
+// options object from multiple threads.
+//
+
+#include <pthread.h>
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <cassert>
+
+#include "test.hxx"
+
+using namespace std;
+
+typedef vector<string> args;
+
+static vector<args> lines;
+static pthread_barrier_t barrier;
+
+// Shared options object. Its lazy option is read before the threads
+// are started.
+//
+static const options* shared;
+
+static const size_t thread_count = 8;
+static const size_t iterations = 20;
+
+static string
+parse (const args& a)
+{
+  vector<char*> argv;
+  argv.push_back (const_cast<char*> ("driver"));
+
+  for (size_t i (0); i != a.size (); ++i)
+    argv.push_back (const_cast<char*> (a[i].c_str ()));
+
+  int argc (static_cast<int> (argv.size ()));
+  ostringstream r;
+
+  try
+  {
+    options o (argc, &argv[0]);
+
+    r << o.verbose () << ' ' << o.level () << ' ' << o.ratio () << ' '
+      << o.name () << ' ' << o.I ().size ();
+
+    for (map<string, int>::const_iterator i (o.D ().begin ());
+         i != o.D ().end (); ++i)
+      r << ' ' << i->first << '=' << i->second;
+  }
+  catch (const cli::exception& e)
+  {
+    r << "error: " << e;
+  }
+
+  return r.str ();
+}
+
+struct result
+{
+  size_t id;
+  size_t desc;
+  vector<string> out;
+};
+
+extern "C" void*
+work (void* p)
+{
+  result& r (*static_cast<result*> (p));
+  r.out.resize (lines.size ());
+
+  pthread_barrier_wait (&barrier);
+
+  r.desc = options::description ().size ();
+
+  for (size_t k (0); k != iterations; ++k)
+  {
+    // Walk the lines in a different order in each thread.
+    //
+    for (size_t j (0); j != lines.size (); ++j)
+    {
+      size_t i ((j * 7 + r.id * 13 + k) % lines.size ());
+      string s (parse (lines[i]));
+
+      assert (shared->prefix () == "/usr" && shared->level () == 1);
+
+      if (k == 0)
+        r.out[i] = s;
+      else
+        assert (r.out[i] == s);
+    }
+  }
+
+  return 0;
+}
+
+int
+main ()
+{
+  // Generate command lines, some of them invalid.
+  //
+  for (size_t i (0); i != 503; ++i)
+  {
+    ostringstream l, n, d, f;
+    l << i;
+    n << "name-" << i;
+    d << "k" << i % 5 << '=' << i;
+    f << i % 10 << ".25";
+
+    args a;
+
+    if (i % 3 == 0)
+      a.push_back ("-v");
+
+    a.push_back (i % 2 ? "--level" : "-l");
+    a.push_back (i % 97 == 0 ? "x" : l.str ());
+
+    a.push_back ("--ratio");
+    a.push_back (i % 53 == 0 ? "1.5e" : f.str ());
+
+    for (size_t j (0); j != i % 4; ++j)
+      a.push_back ("-I"), a.push_back (n.str ());
+
+    a.push_back ("-D");
+    a.push_back (d.str ());
+
+    if (i % 101 == 0)
+      a.push_back ("--unknown");
+
+    a.push_back ("--name");
+
+    if (i % 89 != 0)
+      a.push_back (n.str ());
+
+    lines.push_back (a);
+  }
+
+  // Nothing is parsed before the threads are started so that the
+  // lookup table and description are initialized concurrently. The
+  // lazy option of the shared object is read once before it is shared
+  // between the threads.
+  //
+  options so;
+  so.prefix ();
+  shared = &so;
+
+  vector<result> rs (thread_count);
+  vector<pthread_t> ts (thread_count);
+
+  pthread_barrier_init (&barrier, 0, static_cast<unsigned> (thread_count));
+
+  for (size_t t (0); t != thread_count; ++t)
+  {
+    rs[t].id = t;
+    assert (pthread_create (&ts[t], 0, &work, &rs[t]) == 0);
+  }
+
+  for (size_t t (0); t != thread_count; ++t)
+    pthread_join (ts[t], 0);
+
+  pthread_barrier_destroy (&barrier);
+
+  // Compare to the sequential results.
+  //
+  size_t desc (options::description ().size ());
+  assert (desc == 7);
+
+  for (size_t i (0); i != lines.size (); ++i)
+  {
+    string s (parse (lines[i]));
+
+    for (size_t t (0); t != thread_count; ++t)
+    {
+      assert (rs[t].desc == desc);
+      assert (rs[t].out[i] == s);
+    }
+  }
+
+  // Spot-check a few of the results.
+  //
+  assert (parse (lines[1]) == "0 1 1.25 name-1 1 k1=1");
+  assert (parse (lines[0]).compare (0, 7, "error: ") == 0);
+  assert (parse (lines[53]).compare (0, 7, "error: ") == 0);
+}